@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+
+// Time source for the game logic. The interactive game reads the steady clock;
+// tests, simulations and benchmarks drive a ManualClock so a game can run
+// without a terminal and much faster than wall-clock time.
+class Clock {
+public:
+    virtual ~Clock() = default;
+    [[nodiscard]] virtual double now() const = 0; // seconds since an arbitrary epoch
+};
+
+class SteadyClock final : public Clock {
+public:
+    [[nodiscard]] double now() const override {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+class ManualClock final : public Clock {
+public:
+    [[nodiscard]] double now() const override { return _now; }
+    void advance(const double seconds) { _now += seconds; }
+    void set(const double seconds) { _now = seconds; }
+
+private:
+    double _now{};
+};
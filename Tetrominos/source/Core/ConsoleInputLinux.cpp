@@ -0,0 +1,168 @@
+#include "ConsoleSession.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <thread>
+
+#include "KeyDecoder.h"
+#include "SpscRing.h"
+
+using namespace std;
+
+static constexpr size_t kMaxEvents = 256; // key events the game has not taken yet; more are dropped
+static constexpr int kSequenceWaitMs = static_cast<int>(KeyDecoder::kSequenceWait * 1000);
+
+// Reads stdin on its own thread while the game reads the keys. The thread
+// pushes one event per read() into the ring and signals `arrived`; the game's
+// thread is the only one that pops. Menus read stdin themselves (Platform::
+// getKey), so a request to stop reading waits until the thread has seen it.
+class ConsoleInput::Reader {
+public:
+    enum class State { Idle, Reading, Stopped };
+
+    explicit Reader(const Clock &clock);
+    ~Reader();
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    void request(State state);
+
+    SpscRing<KeyEvent, kMaxEvents> events;
+    int arrived{-1}; // eventfd, readable once an event was pushed
+
+private:
+    void run();
+    void readKeys();
+    void publish(double time);
+
+    const Clock &_clock;
+    int _control{-1}; // eventfd, readable once a state was requested
+    atomic<State> _requested{State::Idle};
+    atomic<State> _state{State::Idle};
+    bool _closed{}; // stdin reached its end; nothing more is read
+    double _lastRead{}; // clock time of the last read, which an unfinished sequence came in
+    KeyDecoder _decoder;
+    thread _thread;
+};
+
+ConsoleInput::Reader::Reader(const Clock &clock) : _clock(clock) {
+    arrived = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _control = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    // Signals (SIGWINCH on a resize, SIGINT) go to the game's thread, where they end waitForKey()
+    sigset_t all;
+    sigset_t previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    _thread = thread([this] { run(); });
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+ConsoleInput::Reader::~Reader() {
+    request(State::Stopped);
+    _thread.join();
+    close(arrived);
+    close(_control);
+}
+
+void ConsoleInput::Reader::request(const State state) {
+    _requested.store(state, memory_order_release);
+    const uint64_t one = 1;
+    (void)write(_control, &one, sizeof(one));
+    while (_state.load(memory_order_acquire) != state) this_thread::yield();
+}
+
+void ConsoleInput::Reader::run() {
+    for (;;) {
+        const State state = _requested.load(memory_order_acquire);
+        _state.store(state, memory_order_release);
+        if (state == State::Stopped) return;
+
+        const bool reading = state == State::Reading && !_closed;
+        if (!reading) {
+            _decoder.flush(); // a sequence cut off by a menu is dropped; the menu reads what follows
+            _decoder.discard();
+        }
+        // A lone Escape is the key once the rest of a sequence does not follow
+        pollfd fds[] = {{_control, POLLIN, 0}, {reading ? STDIN_FILENO : -1, POLLIN, 0}};
+        const int ready = ::poll(fds, 2, reading && _decoder.pending() ? kSequenceWaitMs : -1);
+        if (ready == 0) {
+            _decoder.flush();
+            publish(_lastRead);
+        }
+        if (ready <= 0) continue;
+
+        uint64_t requests = 0;
+        if (fds[0].revents & POLLIN) (void)read(_control, &requests, sizeof(requests));
+        if (fds[1].revents & (POLLIN | POLLHUP)) readKeys();
+    }
+}
+
+void ConsoleInput::Reader::readKeys() {
+    char buffer[64];
+    const ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+    _lastRead = _clock.now();
+    if (count == 0) _closed = true;
+    if (count <= 0) return;
+
+    _decoder.receive({buffer, static_cast<size_t>(count)});
+    publish(_lastRead);
+}
+
+void ConsoleInput::Reader::publish(const double time) {
+    if (_decoder.keys().empty()) return;
+    if (!events.push({time, _decoder.take()})) return;
+    const uint64_t one = 1;
+    (void)write(arrived, &one, sizeof(one));
+}
+
+ConsoleInput::ConsoleInput(const Clock &clock) : _reader(make_unique<Reader>(clock)) {}
+
+ConsoleInput::~ConsoleInput() = default;
+
+// Keys are read on the reader thread; one frame's events count as pressed together.
+InputSnapshot ConsoleInput::poll() {
+    vector<KeyEvent> events;
+    takeEvents(0, events);
+    InputSnapshot snapshot;
+    for (const KeyEvent &event : events) snapshot = combine(snapshot, event.keys);
+    return snapshot;
+}
+
+// `arrived` is reset before the ring is emptied, so an event pushed meanwhile
+// is taken now or wakes the next waitForKey().
+void ConsoleInput::takeEvents(double, vector<KeyEvent> &out) {
+    uint64_t pushed = 0;
+    (void)read(_reader->arrived, &pushed, sizeof(pushed));
+    KeyEvent event;
+    while (_reader->events.pop(event)) out.push_back(event);
+}
+
+void ConsoleInput::suspend() {
+    _reader->request(Reader::State::Idle);
+}
+
+void ConsoleInput::resume() {
+    vector<KeyEvent> stale;
+    takeEvents(0, stale);
+    _reader->request(Reader::State::Reading);
+}
+
+// The reader thread signals `arrived` for every key it queues. A signal, such
+// as SIGWINCH on a resize, ends the wait early.
+void ConsoleInput::waitForKey(const double seconds) {
+    if (seconds <= 0) return;
+
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(_reader->arrived, &readable);
+    const auto micros = static_cast<long>(std::ceil(seconds * 1e6));
+    timeval timeout{micros / 1000000, micros % 1000000};
+    (void)select(_reader->arrived + 1, &readable, nullptr, nullptr, &timeout);
+}
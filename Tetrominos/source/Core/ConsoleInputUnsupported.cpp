@@ -0,0 +1,39 @@
+#include "ConsoleSession.h"
+
+#include <chrono>
+#include <thread>
+
+#include "Input.h"
+#include "KeyBindings.h"
+
+// Built instead of ConsoleInputLinux.cpp. Windows reads held keys with
+// GetKeyState rather than from a stream, so there is no reader thread: each
+// poll is one event at the time of the poll, and waiting for a key sleeps.
+class ConsoleInput::Reader {};
+
+ConsoleInput::ConsoleInput(const Clock &) {}
+
+ConsoleInput::~ConsoleInput() = default;
+
+InputSnapshot ConsoleInput::poll() {
+    Input::pollKeys();
+
+    InputSnapshot snapshot;
+    for (int action = 0; action < static_cast<int>(Action::Count); action++)
+        setAction(snapshot, static_cast<Action>(action), Input::action(action));
+    return snapshot;
+}
+
+void ConsoleInput::takeEvents(const double now, std::vector<KeyEvent> &out) {
+    out.push_back({now, poll()});
+}
+
+void ConsoleInput::suspend() {}
+
+void ConsoleInput::resume() {}
+
+// The game asks for at most a frame while its clock runs, so a key is sampled
+// at least once per frame.
+void ConsoleInput::waitForKey(const double seconds) {
+    if (seconds > 0) std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
@@ -0,0 +1,101 @@
+#include "ConsoleSession.h"
+
+#include <iostream>
+
+#include "Input.h"
+#include "KeyBindings.h"
+#include "Platform.h"
+#include "rlutil.h"
+
+using namespace std;
+
+void ConsoleInput::bindDefaultKeys() {
+    for (const auto &binding : kDefaultKeyBindings) Input::bind(static_cast<int>(binding.action), binding.key);
+}
+
+void ConsoleAudio::playSound(const GameSound sound) {
+    switch (sound) {
+        case GameSound::Click: SoundEngine::playSound("CLICK"); break;
+        case GameSound::Lock: SoundEngine::playSound("LOCK"); break;
+        case GameSound::HardDrop: SoundEngine::playSound("HARD_DROP"); break;
+        case GameSound::LineClear: SoundEngine::playSound("LINE_CLEAR"); break;
+        case GameSound::Quad: SoundEngine::playSound("QUAD"); break;
+    }
+}
+
+void ConsoleAudio::playMusic(const string &track) {
+    SoundEngine::playMusic(track);
+}
+
+void ConsoleAudio::pauseMusic() {
+    SoundEngine::pauseMusic();
+}
+
+void ConsoleAudio::unpauseMusic() {
+    SoundEngine::unpauseMusic();
+}
+
+void ConsoleAudio::stopMusic() {
+    SoundEngine::stopMusic();
+}
+
+bool ConsoleAudio::musicEnded() const {
+    return SoundEngine::musicEnded();
+}
+
+string ConsoleAudio::currentMusic() const {
+    return SoundEngine::currentMusicName();
+}
+
+void ConsoleAudio::setMusicVolume(const float volume) {
+    SoundEngine::setMusicVolume(volume);
+}
+
+void ConsoleAudio::setEffectVolume(const float volume) {
+    SoundEngine::setEffectVolume(volume);
+}
+
+void ConsoleAudio::setSoundtrackMode(const SoundtrackMode mode) {
+    SoundEngine::setSoundtrackMode(mode);
+}
+
+float ConsoleAudio::musicVolume() const {
+    return SoundEngine::getMusicVolume();
+}
+
+float ConsoleAudio::effectVolume() const {
+    return SoundEngine::getEffectVolume();
+}
+
+SoundtrackMode ConsoleAudio::soundtrackMode() const {
+    return SoundEngine::getSoundtrackMode();
+}
+
+void ConsoleOutput::clear() {
+    rlutil::cls();
+}
+
+void ConsoleOutput::moveTo(const int x, const int y) {
+    rlutil::locate(x, y);
+}
+
+void ConsoleOutput::setColor(const int foreground, const int background) {
+    rlutil::setBackgroundColor(background);
+    rlutil::setColor(foreground);
+}
+
+void ConsoleOutput::write(const string_view text) {
+    cout << text;
+}
+
+void ConsoleOutput::flush() {
+    Platform::flushOutput();
+}
+
+int ConsoleOutput::originX() const {
+    return Platform::offsetX();
+}
+
+int ConsoleOutput::originY() const {
+    return Platform::offsetY();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+
+#include "Session.h"
+
+// The local terminal's session: Input key bindings, SoundEngine and rlutil.
+// Those KonsoleGE facilities are process-wide, so a process has at most one
+// ConsoleSession; everything else goes through the Session interfaces.
+
+// Keys of the local terminal. On Linux a reader thread owns stdin while a game
+// runs, between resume() and suspend(): it reads each key as it arrives,
+// timestamps it on the session clock and queues it in a lock-free ring for
+// takeEvents(), so a key keeps the time it was pressed however late the next
+// frame comes. Windows reads held keys with GetKeyState, so there each poll is
+// one event at the time of the poll.
+class ConsoleInput final : public InputSource {
+public:
+    explicit ConsoleInput(const Clock &clock);
+    ~ConsoleInput() override;
+    ConsoleInput(const ConsoleInput &) = delete;
+    ConsoleInput &operator=(const ConsoleInput &) = delete;
+
+    static void bindDefaultKeys();
+    // Blocks until a key may have arrived or `seconds` have passed.
+    void waitForKey(double seconds);
+    [[nodiscard]] InputSnapshot poll() override;
+    void takeEvents(double now, std::vector<KeyEvent> &out) override;
+    void suspend() override;
+    void resume() override;
+
+private:
+    class Reader;
+    std::unique_ptr<Reader> _reader;
+};
+
+class ConsoleAudio final : public AudioSink {
+public:
+    void playSound(GameSound sound) override;
+    void playMusic(const std::string &track) override;
+    void pauseMusic() override;
+    void unpauseMusic() override;
+    void stopMusic() override;
+    [[nodiscard]] bool musicEnded() const override;
+    [[nodiscard]] std::string currentMusic() const override;
+
+    void setMusicVolume(float volume) override;
+    void setEffectVolume(float volume) override;
+    void setSoundtrackMode(SoundtrackMode mode) override;
+    [[nodiscard]] float musicVolume() const override;
+    [[nodiscard]] float effectVolume() const override;
+    [[nodiscard]] SoundtrackMode soundtrackMode() const override;
+};
+
+class ConsoleOutput final : public OutputSink {
+public:
+    void clear() override;
+    void moveTo(int x, int y) override;
+    void setColor(int foreground, int background) override;
+    void write(std::string_view text) override;
+    void flush() override;
+    [[nodiscard]] int originX() const override;
+    [[nodiscard]] int originY() const override;
+};
+
+class ConsoleSession {
+public:
+    ConsoleSession() = default;
+    ConsoleSession(const ConsoleSession &) = delete;
+    ConsoleSession &operator=(const ConsoleSession &) = delete;
+
+    [[nodiscard]] const Session &session() const { return _session; }
+    [[nodiscard]] ConsoleInput &input() { return _input; }
+
+private:
+    SteadyClock _clock;
+    ConsoleInput _input{_clock};
+    ConsoleAudio _audio;
+    ConsoleOutput _output;
+    Session _session{_clock, _input, _audio, _output};
+};
@@ -1,7 +1,6 @@
 #pragma once
 
-#include <deque>
-#include <array>
+#include <cstddef>
 
 constexpr int BOARD_HEIGHT = 40;
 constexpr int BOARD_WIDTH = 10;
@@ -12,13 +11,15 @@ constexpr int MATRIX_END = 39;
 constexpr int SKYLINE_START = 18;
 constexpr int MIN_LEVEL = 1;
 constexpr int MAX_LEVEL = 15;
+constexpr int MAX_MASTER_LEVEL = 30; // Master keeps levelling up past MAX_LEVEL
 constexpr int VISIBLE_ROWS = MATRIX_END - MATRIX_START + 1;
 constexpr int OVERLAY_LEVEL_THRESHOLD = 10;
+constexpr int DEFAULT_TICK_RATE = 1000; // fixed simulation ticks per second
+constexpr int MIN_TICK_RATE = 60;
+constexpr int MAX_TICK_RATE = 10000;
 
-enum class GameVariant { Marathon, Sprint, Ultra };
-inline constexpr size_t VARIANT_COUNT = 3;
+enum class GameVariant { Marathon, Sprint, Ultra, Master };
+inline constexpr size_t VARIANT_COUNT = 4;
 enum class LockDownMode { Extended, ExtendedInfinity, Classic };
 enum class DropType { Normal, Soft, Hard };
-
-using MatrixRow = std::array<int, BOARD_WIDTH>;
-using GameMatrix = std::deque<MatrixRow>;
+enum class RandomizerType { SevenBag, FourteenBag, Memoryless, TgmHistory };
@@ -1,57 +1,93 @@
 #include "GameController.h"
 
-#include "Timer.h"
-#include "Random.h"
-
 using namespace std;
 
-static constexpr auto kGeneration = "generation";
-
-static constexpr double kGenerationDelay = 0.2;
-
-GameController::GameController(Timer &timer)
-    : _timer(timer), _lockDownPolicy(makeLockDownPolicy()), _scoringRule(makeDefaultScoringRule()),
-      _gravityPolicy(makeDefaultGravityPolicy()), _goalPolicy(makeDefaultGoalPolicy()), _variantRule(makeVariantRule()),
-      _movement(timer, _lockDownPolicy.get(), _gravityPolicy.get()),
-      _lineClear(timer, _scoringRule.get(), _goalPolicy.get(), _variantRule.get()) {
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::BasicGameController(const Clock &clock)
+    : _timer(clock), _lockDownPolicy([] { return makeLockDownPolicy(); }), _scoringRule(makeDefaultScoringRule),
+      _gravityPolicy(makeDefaultGravityPolicy), _goalPolicy(makeDefaultGoalPolicy),
+      _variantRule([] { return makeVariantRule(); }),
+      _timings(makeTickTimings(DEFAULT_TICK_RATE, *_gravityPolicy, *_variantRule)),
+      _movement(_timer, _timings, _lockDownPolicy.get()),
+      _lineClear(_timer, _timings, _scoringRule.get(), _goalPolicy.get(), _variantRule.get()) {
 }
 
-GameController::~GameController() = default;
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::~BasicGameController() = default;
 
-void GameController::configurePolicies(const LockDownMode mode) {
-    _lockDownPolicy = makeLockDownPolicy(mode);
-    _movement.setLockDownPolicy(_lockDownPolicy.get());
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::configurePolicies(const LockDownMode mode) {
+    if constexpr (PolicySlot<LockDown>::kConfigurable) {
+        _lockDownPolicy.reset(makeLockDownPolicy(mode));
+        _movement.setLockDownPolicy(_lockDownPolicy.get());
+    } else {
+        (void)mode;
+    }
 }
 
-void GameController::configureVariant(const GameVariant variant, GameState &state) {
-    _variantRule = makeVariantRule(variant);
-    _lineClear.setVariantRule(_variantRule.get());
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::configureVariant(const GameVariant variant,
+                                                                                      GameState &state) {
+    if constexpr (PolicySlot<Variant>::kConfigurable) {
+        _variantRule.reset(makeVariantRule(variant));
+        _lineClear.setVariantRule(_variantRule.get());
+    } else {
+        (void)variant;
+    }
+    _timings = makeTickTimings(_timings.tickRate, *_gravityPolicy, *_variantRule);
     state.config.timeLimit = _variantRule->timeLimit();
     state.config.showGoal = _variantRule->levelUp();
 }
 
-void GameController::start(GameState &state) const {
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::setTickRate(const int tickRate) {
+    _timings = makeTickTimings(tickRate, *_gravityPolicy, *_variantRule);
+    _timer.setTickRate(tickRate);
+}
+
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::snapshot(const GameState &state,
+                                                                              GameSnapshot &out) const {
+    state.snapshot(out);
+    out.timers = _timer.snapshot();
+}
+
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::restore(GameState &state,
+                                                                             const GameSnapshot &snapshot) {
+    _timer.sample();
+    state.restore(snapshot);
+    _timer.restore(snapshot.timers);
+}
+
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::start(GameState &state) {
+    _timer.sample();
     reset(state);
     state.flags.isStarted = true;
     state.phase = GamePhase::Generation;
-    _timer.resetTimer(kGeneration, kGenerationDelay);
+    _timer.resetTimer(GameTimer::Generation, _timings.generationDelay);
 }
 
-StepResult GameController::step(GameState &state, const InputSnapshot &input) {
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+StepResult BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::step(GameState &state,
+                                                                                 const InputSnapshot &input) {
     if (state.shouldExit()) return StepResult::Continue;
 
     if (!state.flags.isStarted) return StepResult::Continue;
 
+    _timer.sample();
+    _lastInput = input;
+
     if (state.hardDropTrail.active) {
-        constexpr double kTrailDuration = 0.15;
-        const double elapsed = _timer.getSeconds("harddroptrail");
-        if (elapsed >= kTrailDuration) {
+        const int64_t elapsed = _timer.getTicks(GameTimer::HardDropTrail);
+        if (elapsed >= _timings.hardDropTrail) {
             state.hardDropTrail.active = false;
             state.markDirty();
         } else {
-            const double t = elapsed / kTrailDuration;
             const int total = state.hardDropTrail.endRow - state.hardDropTrail.startRow;
-            const int newStart = state.hardDropTrail.startRow + static_cast<int>(t * static_cast<double>(total));
+            const int newStart =
+                state.hardDropTrail.startRow + static_cast<int>(elapsed * total / _timings.hardDropTrail);
             if (newStart != state.hardDropTrail.visibleStartRow) {
                 state.hardDropTrail.visibleStartRow = newStart;
                 state.markDirty();
@@ -85,7 +121,37 @@ StepResult GameController::step(GameState &state, const InputSnapshot &input) {
     return result;
 }
 
-void GameController::reset(GameState &state) const {
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+int64_t BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::nextDeadline(const GameState &state) const {
+    if (state.shouldExit() || !state.flags.isStarted || state.flags.isGameOver) return NO_DEADLINE;
+
+    const int64_t next = _timer.now() + 1;
+    int64_t deadline = next; // Pattern, Iterate, Eliminate and Completion take one step each
+    switch (state.phase) {
+        case GamePhase::Generation: deadline = _timer.deadline(GameTimer::Generation, _timings.generationDelay); break;
+        case GamePhase::Falling: deadline = _movement.nextDeadline(state, _lastInput); break;
+        case GamePhase::Animate: deadline = _lineClear.nextDeadline(state); break;
+        default: break;
+    }
+
+    // The trail moves down a row whenever elapsed * total / duration does
+    if (const auto &trail = state.hardDropTrail; trail.active) {
+        const int64_t total = trail.endRow - trail.startRow;
+        const int64_t shown = trail.visibleStartRow - trail.startRow + 1;
+        const int64_t ticks = min((shown * _timings.hardDropTrail + total - 1) / total, _timings.hardDropTrail);
+        deadline = min(deadline, _timer.deadline(GameTimer::HardDropTrail, ticks));
+    }
+
+    // Rounded down: a step that comes a tick early finds the next deadline one tick later
+    if (state.config.timeLimit > 0) {
+        const auto remaining = static_cast<int64_t>(state.displayTime() * _timings.tickRate);
+        deadline = min(deadline, _timer.now() + remaining);
+    }
+    return max(deadline, next);
+}
+
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::reset(GameState &state) {
     state.stats = Stats{};
     state.stats.level = state.config.startingLevel;
     state.stats.goal = _goalPolicy->startingGoalValue(state.stats.level);
@@ -100,67 +166,68 @@ void GameController::reset(GameState &state) const {
         state.stats.lines = _variantRule->linesGoal();
     }
 
-    for (auto &row : state.matrix)
-        row.fill(0);
+    state.matrix.clear();
 
-    state.pieces.hold = nullptr;
-    state.pieces.current = nullptr;
-    state.pieces.bagIndex = 0;
+    state.pieces.hold.reset();
+    state.pieces.current.reset();
     state.pieces.isNewHold = false;
-    shuffle(state, 0);
-    shuffle(state, 7);
+    state.seed = state.config.seed != 0 ? state.config.seed : Rng::makeSeed();
+    state.rng.seed(state.seed);
+    state.pieces.queue.reset(makeRandomizer(state.config.randomizer), state.rng);
 
     state.startGameTimer();
     state.activateHighscore();
 
     _movement.resetTimers();
     _lineClear.resetTimers();
-    _timer.stopTimer(kGeneration);
+    _timer.stopTimer(GameTimer::Generation);
+    _lastInput = {};
 }
 
-void GameController::stepGeneration(GameState &state) const {
-    if (_timer.getSeconds(kGeneration) >= kGenerationDelay) {
-        _timer.stopTimer(kGeneration);
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::stepGeneration(GameState &state) {
+    if (_timer.getTicks(GameTimer::Generation) >= _timings.generationDelay) {
+        _timer.stopTimer(GameTimer::Generation);
         popTetrimino(state);
-        if (!state.pieces.current->setPosition(state.pieces.current->getStartingPosition())) {
+        if (!state.pieces.current->setPosition(state.matrix, state.pieces.current->getStartingPosition())) {
             state.flags.isGameOver = true;
             return;
         }
-        _timer.startTimer("fall");
+        _timer.startTimer(GameTimer::Fall);
+        state.pieces.fallProgress = 0;
         state.phase = GamePhase::Falling;
         state.markDirty();
     }
 }
 
-void GameController::stepCompletion(GameState &state) const {
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::stepCompletion(GameState &state) {
     if (_variantRule->levelUp() && state.stats.goal <= 0) {
         state.stats.level++;
         state.stats.goal = _goalPolicy->goalValue(state.stats.level) + state.stats.goal;
 
-        if (state.stats.level > MAX_LEVEL) {
+        if (state.stats.level > _variantRule->maxLevel()) {
             state.flags.isGameOver = true;
             return;
         }
     }
 
-    _timer.startTimer(kGeneration);
+    _timer.startTimer(GameTimer::Generation);
     state.phase = GamePhase::Generation;
     state.markDirty();
 }
 
-void GameController::shuffle(GameState &state, const size_t start) {
-    for (int i = 6; i >= 0; i--) {
-        const int j = Random::getInteger(0, i);
-        if (i != j)
-            state.pieces.bag[start + static_cast<size_t>(i)].swap(state.pieces.bag[start + static_cast<size_t>(j)]);
-    }
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+void BasicGameController<Gravity, LockDown, Scoring, Goal, Variant>::popTetrimino(GameState &state) {
+    state.pieces.current = Tetrimino(state.pieces.queue.pop(state.rng));
 }
 
-void GameController::popTetrimino(GameState &state) {
-    state.pieces.current = state.pieces.bag[state.pieces.bagIndex++].get();
-    if (state.pieces.bagIndex >= 7) {
-        std::swap_ranges(state.pieces.bag.begin(), state.pieces.bag.begin() + 7, state.pieces.bag.begin() + 7);
-        shuffle(state, 7);
-        state.pieces.bagIndex = 0;
-    }
-}
+template class BasicGameController<GravityPolicy, LockDownPolicy, ScoringRule, GoalPolicy, VariantRule>;
+template class BasicGameController<GuidelineGravity, ExtendedLockDown, GuidelineScoringRule, VariableGoal,
+                                   MarathonVariant>;
+template class BasicGameController<GuidelineGravity, ExtendedLockDown, GuidelineScoringRule, VariableGoal,
+                                   SprintVariant>;
+template class BasicGameController<GuidelineGravity, ExtendedLockDown, GuidelineScoringRule, VariableGoal,
+                                   UltraVariant>;
+template class BasicGameController<GuidelineGravity, ExtendedLockDown, GuidelineScoringRule, VariableGoal,
+                                   MasterVariant>;
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "GameState.h"
+#include "GameTimers.h"
 #include "GoalPolicy.h"
 #include "InputSnapshot.h"
 #include "LineClear.h"
@@ -10,34 +11,70 @@
 #include "ScoringRule.h"
 #include "GravityPolicy.h"
 #include "PieceMovement.h"
+#include "PolicySlot.h"
+#include "TickTimings.h"
 #include "VariantRule.h"
 
-class Timer;
+class Clock;
 
-class GameController {
+// Runs the game phases against one set of rule policies. Each template
+// parameter is either a rule interface (GravityPolicy, LockDownPolicy, ...),
+// held behind a unique_ptr and swappable through configurePolicies() and
+// configureVariant(), or a final policy class held by value, whose calls are
+// direct and inlined. The member definitions live in GameController.cpp and
+// are instantiated for GameController and the GuidelineController rule sets.
+template <class Gravity, class LockDown, class Scoring, class Goal, class Variant>
+class BasicGameController {
 public:
-    explicit GameController(Timer &timer);
-    ~GameController();
+    explicit BasicGameController(const Clock &clock);
+    ~BasicGameController();
 
-    void start(GameState &state) const;
+    void start(GameState &state);
     StepResult step(GameState &state, const InputSnapshot &input);
-    void reset(GameState &state) const;
+    // The first tick after the last step at which step() with the same input
+    // does anything: a phase delay ending, a row of gravity, the lock delay, an
+    // animation frame or the time limit. Stepping only on those ticks and on
+    // the tick an input changes, plus the tick before it (a step applies the
+    // gravity of all the ticks it skipped at its input's rate), plays the game
+    // exactly as stepping every tick; `tetrominos-sim --check-deadlines` checks
+    // that. NO_DEADLINE when the game is not running.
+    [[nodiscard]] int64_t nextDeadline(const GameState &state) const;
+    void reset(GameState &state);
+    // Fixed policies ignore the argument; configureVariant() still writes the variant's settings into the config.
     void configurePolicies(LockDownMode mode);
     void configureVariant(GameVariant variant, GameState &state);
+    // Ticks per second of the clock the controller is stepped against; rebuilds the timing table.
+    void setTickRate(int tickRate);
+    [[nodiscard]] const TickTimings &timings() const { return _timings; }
+    // GameState::snapshot()/restore() plus the running timers. Restoring resumes
+    // the timers from the current tick, with the elapsed ticks they had.
+    void snapshot(const GameState &state, GameSnapshot &out) const;
+    void restore(GameState &state, const GameSnapshot &snapshot);
 
 private:
-    void stepGeneration(GameState &state) const;
-    void stepCompletion(GameState &state) const;
+    void stepGeneration(GameState &state);
+    void stepCompletion(GameState &state);
 
-    static void shuffle(GameState &state, size_t start);
     static void popTetrimino(GameState &state);
 
-    Timer &_timer;
-    std::unique_ptr<LockDownPolicy> _lockDownPolicy;
-    std::unique_ptr<ScoringRule> _scoringRule;
-    std::unique_ptr<GravityPolicy> _gravityPolicy;
-    std::unique_ptr<GoalPolicy> _goalPolicy;
-    std::unique_ptr<VariantRule> _variantRule;
-    PieceMovement _movement;
-    LineClear _lineClear;
+    GameTimers _timer;
+    PolicySlot<LockDown> _lockDownPolicy;
+    PolicySlot<Scoring> _scoringRule;
+    PolicySlot<Gravity> _gravityPolicy;
+    PolicySlot<Goal> _goalPolicy;
+    PolicySlot<Variant> _variantRule;
+    TickTimings _timings;
+    InputSnapshot _lastInput;
+    BasicPieceMovement<LockDown> _movement;
+    BasicLineClear<Scoring, Goal, Variant> _lineClear;
 };
+
+// The interactive game: every rule can be changed between games.
+using GameController =
+    BasicGameController<GravityPolicy, LockDownPolicy, ScoringRule, GoalPolicy, VariantRule>;
+
+// Guideline rules with Extended lock down, fixed at compile time for the
+// headless simulator.
+template <class Variant>
+using GuidelineController =
+    BasicGameController<GuidelineGravity, ExtendedLockDown, GuidelineScoringRule, VariableGoal, Variant>;
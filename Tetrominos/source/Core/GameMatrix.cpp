@@ -0,0 +1,200 @@
+#include "GameMatrix.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "Zobrist.h"
+
+using namespace std;
+
+// fits() widens each row into a 32-bit frame with 8 extra wall bits on both
+// sides, so a footprint can be shifted into place without range checks.
+static constexpr int kFramePadding = 8;
+static constexpr uint32_t kFrameWalls = 0xFF0000FFu;
+static constexpr int kFrameShift = kFramePadding + GameMatrix::kColumnShift - Footprint::kFootprintBias;
+static constexpr int kMinColumn = -kFrameShift;
+static constexpr int kMaxColumn = 31 - kFrameShift - 2 * Footprint::kFootprintBias;
+
+static int countBits(uint16_t mask) {
+    int count = 0;
+    for (; mask != 0; mask &= static_cast<uint16_t>(mask - 1)) count++;
+    return count;
+}
+
+// Index of the lowest set bit of a non-zero mask (de Bruijn multiply).
+static int lowestBit(const uint64_t mask) {
+    static constexpr uint64_t kDeBruijn = 0x03f79d71b4cb0a89ULL;
+    static constexpr int kIndex[64] = {0,  47, 1,  56, 48, 27, 2,  60, 57, 49, 41, 37, 28, 16, 3,  61,
+                                       54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11, 4,  62,
+                                       46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+                                       25, 39, 14, 33, 19, 30, 9,  24, 13, 18, 8,  12, 7,  6,  5,  63};
+    return kIndex[((mask ^ (mask - 1)) * kDeBruijn) >> 58];
+}
+
+static_assert(is_trivially_copyable_v<GameMatrix>);
+
+GameMatrix::GameMatrix() {
+    _rows.fill(kEmptyRow);
+}
+
+void GameMatrix::clear() {
+    _rows.fill(kEmptyRow);
+    for (auto &row : _colors)
+        row.fill(0);
+    _base = 0;
+    _fullRows = 0;
+    _columns.fill(0);
+    _heights.fill(0);
+    _holes = 0;
+    _hash = 0;
+    _version++;
+}
+
+void GameMatrix::set(const int row, const int column, const int color) {
+    auto &mask = _rows[slot(row)];
+    const bool wasOccupied = (mask & columnBit(column)) != 0;
+    if (color != 0)
+        mask = static_cast<uint16_t>(mask | columnBit(column));
+    else
+        mask = static_cast<uint16_t>(mask & ~columnBit(column));
+    _colors[slot(row)][static_cast<size_t>(column)] = color;
+
+    if (wasOccupied == (color != 0)) return;
+    _version++;
+    _hash ^= zobristCell(row, column);
+
+    if (color == 0) {
+        // Only debug scenarios empty a cell; recount rather than track the removal.
+        rebuildFeatures();
+        return;
+    }
+
+    if (mask == kFullRow) _fullRows |= uint64_t{1} << row;
+    _columns[static_cast<size_t>(column)] |= uint64_t{1} << row;
+
+    // A mino above the column top leaves holes over the cells it skipped;
+    // a mino below the top fills a hole.
+    auto &height = _heights[static_cast<size_t>(column)];
+    if (const int cellHeight = BOARD_HEIGHT - row; cellHeight > height) {
+        _holes += cellHeight - height - 1;
+        height = static_cast<uint8_t>(cellHeight);
+    } else {
+        _holes--;
+    }
+}
+
+void GameMatrix::loadRows(const array<uint16_t, BOARD_HEIGHT> &rows, const int color) {
+    clear();
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        const uint16_t mask = rows[static_cast<size_t>(row)] | kEmptyRow;
+        _rows[slot(row)] = mask;
+        for (int column = 0; column < BOARD_WIDTH; column++)
+            if (mask & columnBit(column)) _colors[slot(row)][static_cast<size_t>(column)] = color;
+    }
+    rebuildFeatures();
+}
+
+int GameMatrix::rowFill(const int row) const {
+    return countBits(static_cast<uint16_t>(rowMask(row) & kInterior));
+}
+
+// One top-down pass over the row masks: a column's height is set by the first
+// row that covers it, and every empty cell under a covered column is a hole.
+void GameMatrix::rebuildFeatures() {
+    _fullRows = 0;
+    _columns.fill(0);
+    _heights.fill(0);
+    _holes = 0;
+    _hash = 0;
+
+    uint16_t covered = 0;
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        const uint16_t mask = rowMask(row);
+        if (mask == kFullRow) _fullRows |= uint64_t{1} << row;
+
+        const uint16_t cells = mask & kInterior;
+        for (uint16_t rest = cells; rest != 0; rest &= static_cast<uint16_t>(rest - 1)) {
+            const int column = lowestBit(rest) - kColumnShift;
+            _columns[static_cast<size_t>(column)] |= uint64_t{1} << row;
+            _hash ^= zobristCell(row, column);
+        }
+        _holes += countBits(static_cast<uint16_t>(covered & ~cells));
+        if (const uint16_t uncovered = cells & static_cast<uint16_t>(~covered); uncovered != 0) {
+            for (int column = 0; column < BOARD_WIDTH; column++)
+                if (uncovered & columnBit(column))
+                    _heights[static_cast<size_t>(column)] = static_cast<uint8_t>(BOARD_HEIGHT - row);
+            covered |= uncovered;
+        }
+    }
+}
+
+bool GameMatrix::isOccupied(const int row, const int column) const {
+    if (row < 0 || row >= BOARD_HEIGHT || column < 0 || column >= BOARD_WIDTH) return true;
+    return (rowMask(row) & columnBit(column)) != 0;
+}
+
+int GameMatrix::color(const int row, const int column) const {
+    return _colors[slot(row)][static_cast<size_t>(column)];
+}
+
+bool GameMatrix::fits(const Footprint &footprint, const int row, const int column) const {
+    if (column < kMinColumn || column > kMaxColumn) return false;
+
+    const int shift = column + kFrameShift;
+    for (int i = 0; i < footprint.rowCount; i++) {
+        const int r = row + footprint.topRow + i;
+        if (r < 0 || r >= BOARD_HEIGHT) return false;
+
+        const uint32_t frame = kFrameWalls | (static_cast<uint32_t>(rowMask(r)) << kFramePadding);
+        if (frame & (static_cast<uint32_t>(footprint.masks[static_cast<size_t>(i)]) << shift)) return false;
+    }
+    return true;
+}
+
+// For every column the piece covers, the cells between its lowest mino and the
+// next occupied cell (or the floor) are free, so the drop is the smallest such
+// gap: one shift and one lowest-bit lookup per column.
+int GameMatrix::dropDistance(const Footprint &footprint, const int row, const int column) const {
+    static constexpr uint64_t kFloor = uint64_t{1} << BOARD_HEIGHT;
+
+    int distance = BOARD_HEIGHT;
+    for (int i = 0; i < Footprint::kWidth; i++) {
+        const int bottom = footprint.bottoms[static_cast<size_t>(i)];
+        if (bottom == Footprint::kNoMino) continue;
+
+        const int c = column + i - Footprint::kFootprintBias;
+        const uint64_t below = (_columns[static_cast<size_t>(c)] | kFloor) >> (row + bottom + 1);
+        distance = min(distance, lowestBit(below));
+    }
+    return distance;
+}
+
+// Single compaction pass. Walking down from the topmost cleared row, every
+// kept row moves up over the cleared slots seen so far; then the base moves up
+// by the number of cleared rows, which shifts every row down by that much. The
+// rows above the topmost clear keep their slots, and the slots the base moves
+// onto (outside the old 40-row window) become the new empty top rows.
+void GameMatrix::eliminateRows(const vector<int> &rows) {
+    if (rows.empty()) return;
+
+    auto cleared = rows.rbegin(); // topmost cleared row first
+    int removed = 0;
+    for (int row = *cleared; row < BOARD_HEIGHT; row++) {
+        if (cleared != rows.rend() && row == *cleared) {
+            removed++;
+            ++cleared;
+            continue;
+        }
+        _rows[slot(row - removed)] = _rows[slot(row)];
+        _colors[slot(row - removed)] = _colors[slot(row)];
+    }
+
+    _base = (_base - static_cast<size_t>(removed)) & (kRingCapacity - 1);
+    for (int row = 0; row < removed; row++) {
+        _rows[slot(row)] = kEmptyRow;
+        _colors[slot(row)] = MatrixRow{};
+    }
+    _version++;
+
+    rebuildFeatures();
+}
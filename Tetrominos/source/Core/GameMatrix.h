@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Constants.h"
+
+using MatrixRow = std::array<int, BOARD_WIDTH>;
+
+// Piece shape as one occupancy mask per row, used for mask-based collision.
+// Bit i of a mask marks column offset (i - kFootprintBias) from the piece position.
+struct Footprint {
+    static constexpr int kFootprintBias = 2;
+
+    static constexpr int kWidth = 5; // mask bits a piece can use
+    static constexpr int8_t kNoMino = -128;
+
+    int topRow{}; // row offset of masks[0] from the piece position
+    int rowCount{};
+    std::array<uint16_t, 4> masks{};
+    // bottoms[i]: row offset of the lowest mino in column offset (i - kFootprintBias), kNoMino if none
+    std::array<int8_t, kWidth> bottoms{};
+};
+
+// The playfield as an occupancy bitboard (one 16-bit mask per row) plus a
+// color plane. Collision and line detection only read the bitboard; the colors
+// are for the renderer.
+//
+// Board features are kept up to date as cells are set: a bitmask of full rows,
+// the height of every column and the number of holes (empty cells under a
+// column's top), plus one occupancy bitmask per column for drop distances.
+// Line clears rebuild them in one pass over the row masks. version() changes
+// whenever the occupancy does, so callers can cache results derived from it.
+// hash() is the Zobrist hash of the occupied cells: set() updates it with one
+// XOR and a line clear recomputes it in the same pass as the features.
+//
+// Row mask layout: column c is bit (c + kColumnShift). The three bits on each
+// side are permanently set walls, so a full row is 0xFFFF and out-of-bounds
+// columns always collide.
+//
+// Rows live in a fixed ring of kRingCapacity slots; row r is slot (base + r).
+// A line clear compacts the rows below the topmost cleared row in one pass and
+// moves the base, so the rows above never move and nothing is allocated. The
+// matrix is trivially copyable.
+class GameMatrix {
+public:
+    static constexpr int kColumnShift = 3;
+    static constexpr uint16_t kEmptyRow = 0xE007;
+    static constexpr uint16_t kFullRow = 0xFFFF;
+
+    GameMatrix();
+
+    void clear();
+    void set(int row, int column, int color);
+    // Replaces the whole matrix with row masks (e.g. from a SimState); every occupied cell gets `color`.
+    void loadRows(const std::array<uint16_t, BOARD_HEIGHT> &rows, int color);
+
+    [[nodiscard]] bool isOccupied(int row, int column) const;
+    [[nodiscard]] int color(int row, int column) const;
+    [[nodiscard]] uint16_t rowMask(const int row) const { return _rows[slot(row)]; }
+    [[nodiscard]] bool isRowFull(int row) const { return rowMask(row) == kFullRow; }
+    [[nodiscard]] bool fits(const Footprint &footprint, int row, int column) const;
+    // Rows a fitting piece can fall before it rests, in O(piece width).
+    [[nodiscard]] int dropDistance(const Footprint &footprint, int row, int column) const;
+    [[nodiscard]] uint32_t version() const { return _version; }
+    [[nodiscard]] uint64_t hash() const { return _hash; }
+
+    [[nodiscard]] int rowFill(int row) const; // minos in the row
+    [[nodiscard]] uint64_t fullRows() const { return _fullRows; } // bit r set when row r is full
+    [[nodiscard]] int height(const int column) const { return _heights[static_cast<size_t>(column)]; } // 0 if empty
+    [[nodiscard]] int holeCount() const { return _holes; }
+
+    // rows must be sorted descending (lowest row first); everything above moves down
+    void eliminateRows(const std::vector<int> &rows);
+
+    static constexpr uint16_t columnBit(const int column) {
+        return static_cast<uint16_t>(1u << (column + kColumnShift));
+    }
+
+private:
+    static constexpr uint16_t kInterior = static_cast<uint16_t>(~kEmptyRow);
+    static_assert(BOARD_HEIGHT <= 64, "fullRows() holds one bit per row");
+
+    // Power of two with room above BOARD_HEIGHT for the empty rows a clear adds.
+    static constexpr size_t kRingCapacity = 64;
+    static_assert(kRingCapacity >= 2 * BOARD_HEIGHT - MATRIX_START);
+
+    [[nodiscard]] size_t slot(const int row) const {
+        return (_base + static_cast<size_t>(row)) & (kRingCapacity - 1);
+    }
+    void rebuildFeatures();
+
+    std::array<uint16_t, kRingCapacity> _rows{};
+    std::array<MatrixRow, kRingCapacity> _colors{};
+    size_t _base{};
+
+    uint64_t _fullRows{};
+    std::array<uint64_t, BOARD_WIDTH> _columns{}; // bit r set when (r, column) is occupied
+    std::array<uint8_t, BOARD_WIDTH> _heights{};
+    int _holes{};
+    uint32_t _version{};
+    uint64_t _hash{};
+};
@@ -9,7 +9,7 @@
 #include "GameRenderer.h"
 #include "HighScoreDisplay.h"
 #include "HelpDisplay.h"
-#include "SoundEngine.h"
+#include "Session.h"
 #include "Utility.h"
 #include "rlutil.h"
 
@@ -40,13 +40,13 @@ GameMenus::~GameMenus() {
 }
 
 void GameMenus::syncSoundToMenu(Menu &menu) {
-    int musicStep = clamp(static_cast<int>(lroundf(SoundEngine::getMusicVolume() * 50)), 0, 10);
+    int musicStep = clamp(static_cast<int>(lroundf(_game->audio().musicVolume() * 50)), 0, 10);
     menu.setValueChoice("Music", _volumeValues[static_cast<size_t>(musicStep)]);
 
-    int effectStep = clamp(static_cast<int>(lroundf(SoundEngine::getEffectVolume() * 10)), 0, 10);
+    int effectStep = clamp(static_cast<int>(lroundf(_game->audio().effectVolume() * 10)), 0, 10);
     menu.setValueChoice("Effects", _volumeValues[static_cast<size_t>(effectStep)]);
 
-    auto stMode = SoundEngine::getSoundtrackMode();
+    auto stMode = _game->audio().soundtrackMode();
     string stStr = "Cycle";
     if (stMode == SoundtrackMode::Random) stStr = "Random";
     else if (stMode == SoundtrackMode::TrackA) stStr = "A";
@@ -59,17 +59,17 @@ void GameMenus::applySoundFromMenu(Menu &menu) {
     auto values = menu.generateValues();
 
     auto hashes = count(values["Music"].begin(), values["Music"].end(), '#');
-    SoundEngine::setMusicVolume(static_cast<float>(hashes) * 0.02f);
+    _game->audio().setMusicVolume(static_cast<float>(hashes) * 0.02f);
 
     hashes = count(values["Effects"].begin(), values["Effects"].end(), '#');
-    SoundEngine::setEffectVolume(static_cast<float>(hashes) * 0.1f);
+    _game->audio().setEffectVolume(static_cast<float>(hashes) * 0.1f);
 
     const auto &st = values["Soundtrack"];
-    if (st == "Random") SoundEngine::setSoundtrackMode(SoundtrackMode::Random);
-    else if (st == "A") SoundEngine::setSoundtrackMode(SoundtrackMode::TrackA);
-    else if (st == "B") SoundEngine::setSoundtrackMode(SoundtrackMode::TrackB);
-    else if (st == "C") SoundEngine::setSoundtrackMode(SoundtrackMode::TrackC);
-    else SoundEngine::setSoundtrackMode(SoundtrackMode::Cycle);
+    if (st == "Random") _game->audio().setSoundtrackMode(SoundtrackMode::Random);
+    else if (st == "A") _game->audio().setSoundtrackMode(SoundtrackMode::TrackA);
+    else if (st == "B") _game->audio().setSoundtrackMode(SoundtrackMode::TrackB);
+    else if (st == "C") _game->audio().setSoundtrackMode(SoundtrackMode::TrackC);
+    else _game->audio().setSoundtrackMode(SoundtrackMode::Cycle);
 }
 
 void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDisplay &help) {
@@ -92,9 +92,12 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
     variants.emplace_back("Marathon");
     variants.emplace_back("Sprint");
     variants.emplace_back("Ultra");
+    variants.emplace_back("Master");
 
     vector<string> ghostValues = {"On", "Off"};
     vector<string> holdValues = {"On", "Off"};
+    vector<string> sonicDropValues = {"Off", "On"};
+    vector<string> practiceValues = {"Off", "On"};
 
     vector<string> previewValues;
     for (int i = 0; i <= 6; i++)
@@ -115,23 +118,31 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
             v = GameVariant::Sprint;
         else if (oc.values.at("Variant") == "Ultra")
             v = GameVariant::Ultra;
+        else if (oc.values.at("Variant") == "Master")
+            v = GameVariant::Master;
         _game->setVariant(v);
+        _game->setPractice(oc.values.at("Practice") == "On");
 
         _game->saveOptions();
     });
     _newGame.addOptionWithValues("Level", levels);
     _newGame.addOptionWithValues("Variant", variants);
+    _newGame.addOptionWithValues("Practice", practiceValues);
 
     _newGame.setOptionHint("Start", "Start a new game with the selected settings.");
     _newGame.setOptionHint("Level", "Starting speed. Higher levels are faster.");
     _newGame.setOptionValueHint("Variant", "Marathon", "Reach over level 15 with the highest score.");
     _newGame.setOptionValueHint("Variant", "Sprint", "Clear 40 lines in the shortest amount of time.");
     _newGame.setOptionValueHint("Variant", "Ultra", "Get the highest score in 2 minutes.");
+    _newGame.setOptionValueHint("Variant", "Master", "Survive to level 30, up to 20G with a shorter lock delay.");
+    _newGame.setOptionValueHint("Practice", "Off", "A ranked game.");
+    _newGame.setOptionValueHint("Practice", "On", "U undoes the last piece. Not ranked or recorded.");
 
     // --- Options menu ---
     _options.addOptionWithValues("Lock Down", lockDownModes);
     _options.addOptionWithValues("Ghost Piece", ghostValues);
     _options.addOptionWithValues("Hold Piece", holdValues);
+    _options.addOptionWithValues("Sonic Drop", sonicDropValues);
     _options.addOptionWithValues("Preview", previewValues);
     _options.addOptionWithValues("Music", _volumeValues);
     _options.addOptionWithValues("Effects", _volumeValues);
@@ -140,6 +151,7 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
         _options.setValueChoice("Lock Down", "Extended");
         _options.setValueChoice("Ghost Piece", "On");
         _options.setValueChoice("Hold Piece", "On");
+        _options.setValueChoice("Sonic Drop", "Off");
         _options.setValueChoice("Preview", Utility::valueToString(6, 2));
         _options.setValueChoice("Music", _volumeValues[5]);
         _options.setValueChoice("Effects", _volumeValues[5]);
@@ -154,6 +166,8 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
     _options.setOptionValueHint("Ghost Piece", "Off", "Hides the landing preview.");
     _options.setOptionValueHint("Hold Piece", "On", "Swap the current piece once per drop.");
     _options.setOptionValueHint("Hold Piece", "Off", "Hold piece is disabled.");
+    _options.setOptionValueHint("Sonic Drop", "Off", "Soft drop speeds up the fall.");
+    _options.setOptionValueHint("Sonic Drop", "On", "Soft drop moves the piece to the bottom without locking.");
     for (int i = 6; i >= 0; i--) {
         string val = Utility::valueToString(i, 2);
         string hint;
@@ -183,7 +197,10 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
             varStr = "Sprint";
         else if (_game->variant() == GameVariant::Ultra)
             varStr = "Ultra";
+        else if (_game->variant() == GameVariant::Master)
+            varStr = "Master";
         _newGame.setValueChoice("Variant", varStr);
+        _newGame.setValueChoice("Practice", _game->practice() ? "On" : "Off");
     });
     _main.addOptionAction("Options", [this]() {
         string modeStr = "Extended";
@@ -194,6 +211,7 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
         _options.setValueChoice("Lock Down", modeStr);
         _options.setValueChoice("Ghost Piece", _game->ghostEnabled() ? "On" : "Off");
         _options.setValueChoice("Hold Piece", _game->holdEnabled() ? "On" : "Off");
+        _options.setValueChoice("Sonic Drop", _game->sonicDrop() ? "On" : "Off");
         _options.setValueChoice("Preview", Utility::valueToString(_game->previewCount(), 2));
 
         syncSoundToMenu(_options);
@@ -209,6 +227,7 @@ void GameMenus::configure(Tetrominos &game, HighScoreDisplay &highScores, HelpDi
         _game->setLockDownMode(mode);
         _game->setGhostEnabled(values["Ghost Piece"] != "Off");
         _game->setHoldEnabled(values["Hold Piece"] != "Off");
+        _game->setSonicDrop(values["Sonic Drop"] == "On");
         int preview = 6;
         try {
             preview = stoi(values["Preview"]);
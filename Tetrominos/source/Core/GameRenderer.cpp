@@ -1,13 +1,12 @@
 #include "GameRenderer.h"
 
 #include <algorithm>
-#include <iostream>
 #include <vector>
 
 #include "GameState.h"
-#include "Platform.h"
 #include "Color.h"
-#include "rlutil.h"
+#include "Platform.h"
+#include "Session.h"
 
 namespace {
 namespace Layout {
@@ -36,19 +35,19 @@ std::vector<std::string> wrapText(const std::string &text, int maxWidth) {
     return lines;
 }
 
-void renderCenteredLine(int x, int y, int width, const std::string &text, int color) {
+void renderCenteredLine(OutputSink &output, int x, int y, int width, const std::string &text, int color) {
     const auto textLen = static_cast<int>(text.length());
     const int leftPad = (width - textLen) / 2;
     const int rightPad = width - textLen - leftPad;
-    rlutil::locate(x, y);
-    rlutil::setBackgroundColor(Color::BLACK);
-    rlutil::setColor(color);
-    std::cout << std::string(static_cast<size_t>(leftPad), ' ') << text
-              << std::string(static_cast<size_t>(rightPad), ' ');
+    output.moveTo(x, y);
+    output.setColor(color, Color::BLACK);
+    output.write(std::string(static_cast<size_t>(leftPad), ' ') + text +
+                 std::string(static_cast<size_t>(rightPad), ' '));
 }
 } // namespace
 
-GameRenderer::GameRenderer() = default;
+GameRenderer::GameRenderer(OutputSink &output) : _output(output) {
+}
 
 GameRenderer::~GameRenderer() = default;
 
@@ -68,8 +67,8 @@ void GameRenderer::configure(const int previewCount, const bool holdEnabled, con
 }
 
 void GameRenderer::updatePositions() {
-    const int ox = Platform::offsetX();
-    const int oy = Platform::offsetY();
+    const int ox = _output.originX();
+    const int oy = _output.originY();
 
     _score.setPosition(Layout::kScoreX + ox, Layout::kScoreY + oy);
     _playfield.setPosition(Layout::kPlayfieldX + ox, Layout::kPlayfieldY + oy);
@@ -88,11 +87,11 @@ void GameRenderer::invalidate() {
 void GameRenderer::render(const GameState &state, const bool playfieldVisible) {
     _playfield.update(state, playfieldVisible);
     if (_previewCount > 0)
-        _next.update(playfieldVisible ? state.peekTetriminos(static_cast<size_t>(_previewCount))
-                                      : std::vector<const Tetrimino *>{});
+        _next.update(playfieldVisible ? state.peekPieces(static_cast<size_t>(_previewCount))
+                                      : std::vector<PieceType>{});
     if (_holdEnabled)
-        _hold.update(playfieldVisible ? std::vector<const Tetrimino *>{state.pieces.hold}
-                                      : std::vector<const Tetrimino *>{});
+        _hold.update(playfieldVisible && state.pieces.hold ? std::vector<PieceType>{state.pieces.hold->getType()}
+                                                           : std::vector<PieceType>{});
     _score.update(state);
 
     _score.render();
@@ -106,8 +105,8 @@ void GameRenderer::render(const GameState &state, const bool playfieldVisible) {
                                  (!lc.notificationText.empty() || !lc.comboText.empty());
 
     if (hasNotification) {
-        const int ox = Platform::offsetX();
-        const int oy = Platform::offsetY();
+        const int ox = _output.originX();
+        const int oy = _output.originY();
         const int baseX = Layout::kNextX + 1 + ox;
         const int baseY = Layout::kSideNotifBaseY + oy;
 
@@ -115,15 +114,14 @@ void GameRenderer::render(const GameState &state, const bool playfieldVisible) {
             const auto lines = wrapText(lc.notificationText, Layout::kSideNotifWidth);
             const int startY = baseY - static_cast<int>(lines.size()) + 1;
             for (size_t i = 0; i < lines.size(); i++)
-                renderCenteredLine(baseX, startY + static_cast<int>(i), Layout::kSideNotifWidth, lines[i],
+                renderCenteredLine(_output, baseX, startY + static_cast<int>(i), Layout::kSideNotifWidth, lines[i],
                                    lc.notificationColor);
         }
 
         if (!lc.comboText.empty())
-            renderCenteredLine(baseX, baseY + 1, Layout::kSideNotifWidth, lc.comboText, lc.comboColor);
+            renderCenteredLine(_output, baseX, baseY + 1, Layout::kSideNotifWidth, lc.comboText, lc.comboColor);
 
-        rlutil::setColor(Color::WHITE);
-        rlutil::setBackgroundColor(Color::BLACK);
+        _output.setColor(Color::WHITE, Color::BLACK);
     }
 
     if (_wasShowingNotification && !hasNotification) {
@@ -132,13 +130,13 @@ void GameRenderer::render(const GameState &state, const bool playfieldVisible) {
     }
     _wasShowingNotification = hasNotification;
 
-    Platform::flushOutput();
+    _output.flush();
 }
 
 void GameRenderer::renderTimer(const GameState &state) {
     _score.updateTimer(state);
     _score.render();
-    Platform::flushOutput();
+    _output.flush();
 }
 
 void GameRenderer::renderTitle(const std::string &subtitle) {
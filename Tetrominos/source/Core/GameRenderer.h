@@ -6,10 +6,13 @@
 #include "PlayfieldDisplay.h"
 
 class GameState;
+class OutputSink;
 
+// Draws a GameState to one session's OutputSink. The panels (score, next,
+// hold, playfield) are KonsoleGE Panels, which write to the process terminal.
 class GameRenderer {
 public:
-    GameRenderer();
+    explicit GameRenderer(OutputSink &output);
     ~GameRenderer();
 
     void configure(int previewCount, bool holdEnabled, bool showGoal);
@@ -21,6 +24,7 @@ public:
 private:
     void updatePositions();
 
+    OutputSink &_output;
     ScoreDisplay _score;
     PieceDisplay _next;
     PieceDisplay _hold;
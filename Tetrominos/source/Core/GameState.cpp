@@ -3,20 +3,20 @@
 #include <algorithm>
 #include <fstream>
 #include <sstream>
-#include <cassert>
 #include <cstring>
 
-#include <cmath>
-
+#include "Clock.h"
+#include "Color.h"
 #include "PieceData.h"
-#include "Platform.h"
-#include "SoundEngine.h"
+#include "SimState.h"
+#include "Zobrist.h"
 
 using namespace std;
 
 static constexpr uint32_t kMagic = 0x53484354; // "TCHS" little-endian
-static constexpr uint32_t kVersion = 5;
-static constexpr size_t kRecordSize = 80;
+static constexpr uint32_t kVersion = 6;
+static constexpr size_t kRecordSize = 88;
+static constexpr size_t kRecordSizeV5 = 80; // before the seed field
 static constexpr size_t kMaxHighscores = 10;
 
 static constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
@@ -33,32 +33,18 @@ static uint64_t computeHash(const char* data, size_t len) {
     return h;
 }
 
-#define SCORE_FILE (Platform::getDataDir() + "/score.bin")
-
 static constexpr uint32_t kOptMagic = 0x54434F50; // "PCOT" little-endian
-static constexpr uint32_t kOptVersion = 3;
-
-#define OPTIONS_FILE (Platform::getDataDir() + "/options.bin")
-
-GameState::GameState() {
-    for (int batch = 0; batch < 2; batch++) {
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::O, matrix));
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::I, matrix));
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::T, matrix));
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::L, matrix));
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::J, matrix));
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::S, matrix));
-        pieces.bag.push_back(std::make_unique<Tetrimino>(PieceType::Z, matrix));
-    }
+static constexpr uint32_t kOptVersion = 4;
 
-    matrix.resize(BOARD_HEIGHT);
+GameState::GameState(const Clock &clock) : _clock(&clock) {
+    pieces.queue.reset(makeRandomizer(config.randomizer), rng);
 }
 
 GameState::~GameState() = default;
 
-static HighScoreRecord readRecord(istream &in) {
+static HighScoreRecord readRecord(istream &in, const size_t recordSize) {
     char buf[kRecordSize]{};
-    in.read(buf, static_cast<streamsize>(kRecordSize));
+    in.read(buf, static_cast<streamsize>(recordSize));
 
     HighScoreRecord rec{};
     int32_t tmp = 0;
@@ -93,6 +79,7 @@ static HighScoreRecord readRecord(istream &in) {
     rec.holdEnabled = (tmp != 0);
     memcpy(&tmp, buf + 76, 4);
     rec.previewCount = tmp;
+    memcpy(&rec.seed, buf + 80, 8);
 
     return rec;
 }
@@ -102,11 +89,11 @@ static void sortAndCap(vector<HighScoreRecord> &hs) {
     if (hs.size() > kMaxHighscores) hs.resize(kMaxHighscores);
 }
 
-void GameState::loadHighscore() {
+void GameState::loadHighscore(const string &path) {
     for (auto &bucket : _highscores)
         bucket.clear();
 
-    ifstream file(SCORE_FILE, ios::binary);
+    ifstream file(path, ios::binary);
     if (!file.is_open()) {
         activateHighscore();
         return;
@@ -124,14 +111,14 @@ void GameState::loadHighscore() {
     memcpy(&magic, fileData.data(), 4);
     memcpy(&version, fileData.data() + 4, 4);
 
-    if (magic != kMagic || (version != 3 && version != 4 && version != kVersion)) {
+    if (magic != kMagic || (version < 3 || version > kVersion)) {
         activateHighscore();
         return;
     }
 
     string parseData = fileData;
 
-    if (version == kVersion) {
+    if (version >= 5) {
         if (parseData.size() < 16) {
             activateHighscore();
             return;
@@ -149,6 +136,8 @@ void GameState::loadHighscore() {
     istringstream in(parseData);
     in.seekg(8); // skip magic + version (already validated)
 
+    const size_t recordSize = version >= 6 ? kRecordSize : kRecordSizeV5;
+
     if (version == 3) {
         // v3 migration: flat record list → Marathon bucket
         uint32_t count = 0;
@@ -161,11 +150,11 @@ void GameState::loadHighscore() {
         auto &marathon = _highscores[static_cast<size_t>(GameVariant::Marathon)];
         for (uint32_t i = 0; i < count; i++) {
             if (!in) break;
-            marathon.push_back(readRecord(in));
+            marathon.push_back(readRecord(in, recordSize));
         }
         sortAndCap(marathon);
     } else {
-        // v4/v5: skip 4-byte reserved field, then per-variant sections
+        // v4+: skip 4-byte reserved field, then per-variant sections
         uint32_t reserved = 0;
         in.read(reinterpret_cast<char *>(&reserved), 4);
 
@@ -178,7 +167,7 @@ void GameState::loadHighscore() {
             const size_t idx = clamp(static_cast<size_t>(variantId), static_cast<size_t>(0), VARIANT_COUNT - 1);
             for (uint32_t i = 0; i < count; i++) {
                 if (!in) break;
-                _highscores[idx].push_back(readRecord(in));
+                _highscores[idx].push_back(readRecord(in, recordSize));
             }
             sortAndCap(_highscores[idx]);
         }
@@ -221,11 +210,12 @@ static void writeRecord(ostream &out, const HighScoreRecord &rec) {
     memcpy(buf + 72, &tmp, 4);
     tmp = static_cast<int32_t>(rec.previewCount);
     memcpy(buf + 76, &tmp, 4);
+    memcpy(buf + 80, &rec.seed, 8);
 
     out.write(buf, static_cast<streamsize>(kRecordSize));
 }
 
-void GameState::saveHighscore() {
+void GameState::saveHighscore(const string &path) {
     if (stats.hasBetterHighscore) {
         HighScoreRecord rec{};
         rec.score = stats.score;
@@ -243,6 +233,7 @@ void GameState::saveHighscore() {
         rec.ghostEnabled = config.ghostEnabled;
         rec.holdEnabled = config.holdEnabled;
         rec.previewCount = config.previewCount;
+        rec.seed = seed;
 
         auto &bucket = _highscores[static_cast<size_t>(config.variant)];
         auto it = lower_bound(bucket.begin(), bucket.end(), rec,
@@ -274,23 +265,18 @@ void GameState::saveHighscore() {
     const string data = buf.str();
     const uint64_t hash = computeHash(data.data(), data.size());
 
-    ofstream out(SCORE_FILE, ios::binary);
+    ofstream out(path, ios::binary);
     if (!out.is_open()) return;
     out.write(data.data(), static_cast<streamsize>(data.size()));
     out.write(reinterpret_cast<const char *>(&hash), 8);
     out.close();
 }
 
-Tetrimino *GameState::peekTetrimino() const {
-    assert(pieces.bagIndex < pieces.bag.size());
-    return pieces.bag[pieces.bagIndex].get();
-}
-
-vector<const Tetrimino *> GameState::peekTetriminos(const size_t count) const {
-    vector<const Tetrimino *> result;
+vector<PieceType> GameState::peekPieces(const size_t count) const {
+    vector<PieceType> result;
     result.reserve(count);
-    for (size_t i = 0; i < count && pieces.bagIndex + i < pieces.bag.size(); i++)
-        result.push_back(pieces.bag[pieces.bagIndex + i].get());
+    for (size_t i = 0; i < count && i < PieceQueue::capacity(); i++)
+        result.push_back(pieces.queue.peek(i));
     return result;
 }
 
@@ -299,12 +285,123 @@ int GameState::tpm() const {
     return (minutes > 0.0) ? static_cast<int>(stats.nbMinos / minutes) : 0;
 }
 
+uint64_t GameState::hash() const {
+    const uint64_t hold = pieces.hold ? zobristHold(pieces.hold->getType()) : 0;
+    return matrix.hash() ^ pieces.queue.hash() ^ hold;
+}
+
+int GameState::dropDistance() const {
+    if (!pieces.current) return 0;
+
+    const Tetrimino &piece = *pieces.current;
+    if (_drop.distance < 0 || _drop.matrixVersion != matrix.version() || _drop.type != piece.getType() ||
+        _drop.rotation != piece.getRotation() || !(_drop.position == piece.getPosition())) {
+        _drop = {piece.getType(), piece.getRotation(), piece.getPosition(), matrix.version(),
+                 piece.dropDistance(matrix)};
+    }
+    return _drop.distance;
+}
+
 int GameState::lpm() const {
     const double minutes = gameElapsed() / 60.0;
     return (minutes > 0.0) ? static_cast<int>(stats.lines / minutes) : 0;
 }
 
+void GameState::snapshot(GameSnapshot &out) const {
+    out.matrix = matrix;
+    out.stats = stats;
+    out.lockDown = lockDown;
+    out.queue = pieces.queue.snapshot();
+    out.current = pieces.current;
+    out.hold = pieces.hold;
+    out.isNewHold = pieces.isNewHold;
+    out.fallProgress = pieces.fallProgress;
+    out.flags = flags;
+    out.phase = phase;
+    out.clearingRows = 0;
+    for (const int row : lineClear.rows) out.clearingRows |= uint64_t{1} << row;
+    out.rng = rng;
+    out.seed = seed;
+    out.gameElapsed = gameElapsed();
+}
+
+void GameState::restore(const GameSnapshot &snapshot) {
+    matrix = snapshot.matrix;
+    stats = snapshot.stats;
+    lockDown = snapshot.lockDown;
+    pieces.queue.restore(snapshot.queue);
+    pieces.current = snapshot.current;
+    pieces.hold = snapshot.hold;
+    pieces.isNewHold = snapshot.isNewHold;
+    pieces.fallProgress = snapshot.fallProgress;
+    flags = snapshot.flags;
+    phase = snapshot.phase;
+    rng = snapshot.rng;
+    seed = snapshot.seed;
+
+    // Descending, as detectFullRows() lists them
+    lineClear.rows.clear();
+    for (int row = BOARD_HEIGHT - 1; row >= 0; row--)
+        if (snapshot.clearingRows & (uint64_t{1} << row)) lineClear.rows.push_back(row);
+    lineClear.flashOn = false;
+    lineClear.notificationText.clear();
+    lineClear.comboText.clear();
+    hardDropTrail = {};
+    _pendingSounds.clear();
+
+    _gameElapsedAccum = snapshot.gameElapsed;
+    _gameTimerStart = _clock->now();
+    // The matrix version may repeat across a restore, so the cache cannot be trusted
+    _drop = {};
+    markDirty();
+}
+
+void GameState::restore(const SimState &sim) {
+    matrix.loadRows(sim.rows, Color::GREY);
+
+    stats.score = sim.score;
+    stats.nbMinos = sim.minos;
+    stats.lines = sim.lines;
+    stats.goal = sim.goal;
+    stats.quad = sim.quads;
+    stats.combos = sim.combos;
+    stats.tSpins = sim.tSpins;
+    stats.currentCombo = sim.currentCombo;
+    stats.level = sim.level;
+    stats.backToBackBonus = sim.has(SimState::BackToBack);
+
+    for (int i = 0; i < SimState::kQueueLength; i++) pieces.queue.replace(static_cast<size_t>(i), sim.queued(i));
+    pieces.current.reset();
+    if (sim.hasCurrent()) pieces.current = sim.piece();
+    pieces.hold.reset();
+    if (sim.hold != SimState::kNoPiece) pieces.hold = Tetrimino(static_cast<PieceType>(sim.hold));
+    pieces.isNewHold = sim.has(SimState::HoldUsed);
+    pieces.fallProgress = sim.fallProgress;
+
+    lockDown.active = sim.has(SimState::LockDownActive);
+    lockDown.moveCount = sim.lockMoves;
+    lockDown.lowestLine = sim.lockLowestRow;
+    phase = static_cast<GamePhase>(sim.phase);
+    flags.stepState = static_cast<GameStep>(sim.stepState);
+    flags.didRotate = sim.has(SimState::DidRotate);
+    flags.lastMoveIsTSpin = sim.has(SimState::TSpin);
+    flags.lastMoveIsMiniTSpin = sim.has(SimState::MiniTSpin);
+    flags.isGameOver = sim.has(SimState::GameOver);
+
+    // From Iterate to Eliminate the rows being cleared are still full in the matrix
+    lineClear = {};
+    if (phase == GamePhase::Iterate || phase == GamePhase::Animate || phase == GamePhase::Eliminate) {
+        for (int row = MATRIX_END; row >= MATRIX_START; row--)
+            if (matrix.isRowFull(row)) lineClear.rows.push_back(row);
+    }
+    hardDropTrail = {};
+    _pendingSounds.clear();
+    _drop = {};
+    markDirty();
+}
+
 void GameState::updateHighscore() {
+    if (config.practice) return; // practice games are never ranked
     if (stats.score > stats.highscore) stats.hasBetterHighscore = true;
     if (stats.hasBetterHighscore) stats.highscore = stats.score;
 }
@@ -314,8 +411,8 @@ void GameState::activateHighscore() {
     stats.highscore = (bucket.size() >= kMaxHighscores) ? bucket[kMaxHighscores - 1].score : 0;
 }
 
-void GameState::loadOptions() {
-    ifstream in(OPTIONS_FILE, ios::binary);
+void GameState::loadOptions(const string &path) {
+    ifstream in(path, ios::binary);
     if (!in.is_open()) return;
 
     uint32_t magic = 0, version = 0;
@@ -340,19 +437,26 @@ void GameState::loadOptions() {
     if (in) config.previewCount = clamp(static_cast<int>(val), 0, 6);
 
     if (version >= 3) {
+        SoundOptions opts;
         in.read(reinterpret_cast<char *>(&val), 4);
-        if (in) SoundEngine::setMusicVolume(static_cast<float>(clamp(static_cast<int>(val), 0, 10)) * 0.02f);
+        if (in) opts.musicVolume = clamp(static_cast<int>(val), 0, 10);
 
         in.read(reinterpret_cast<char *>(&val), 4);
-        if (in) SoundEngine::setEffectVolume(static_cast<float>(clamp(static_cast<int>(val), 0, 10)) * 0.1f);
+        if (in) opts.effectVolume = clamp(static_cast<int>(val), 0, 10);
+
+        in.read(reinterpret_cast<char *>(&val), 4);
+        if (in) opts.soundtrackMode = clamp(static_cast<int>(val), 0, 4);
+        sound = opts;
+    }
 
+    if (version >= 4) {
         in.read(reinterpret_cast<char *>(&val), 4);
-        if (in) SoundEngine::setSoundtrackMode(static_cast<SoundtrackMode>(clamp(static_cast<int>(val), 0, 4)));
+        if (in) config.sonicDrop = (val != 0);
     }
 }
 
-void GameState::saveOptions() const {
-    ofstream out(OPTIONS_FILE, ios::binary);
+void GameState::saveOptions(const string &path) const {
+    ofstream out(path, ios::binary);
     if (!out.is_open()) return;
 
     constexpr uint32_t magic = kOptMagic;
@@ -366,9 +470,11 @@ void GameState::saveOptions() const {
     write32(config.ghostEnabled ? 1 : 0);
     write32(config.holdEnabled ? 1 : 0);
     write32(static_cast<int32_t>(config.previewCount));
-    write32(static_cast<int32_t>(lround(SoundEngine::getMusicVolume() * 50)));
-    write32(static_cast<int32_t>(lround(SoundEngine::getEffectVolume() * 10)));
-    write32(static_cast<int32_t>(SoundEngine::getSoundtrackMode()));
+    const SoundOptions opts = sound.value_or(SoundOptions{});
+    write32(static_cast<int32_t>(opts.musicVolume));
+    write32(static_cast<int32_t>(opts.effectVolume));
+    write32(static_cast<int32_t>(opts.soundtrackMode));
+    write32(config.sonicDrop ? 1 : 0);
 }
 
 void GameState::setStartingLevel(const int level) {
@@ -377,27 +483,27 @@ void GameState::setStartingLevel(const int level) {
 
 void GameState::startGameTimer() {
     _gameElapsedAccum = 0;
-    _gameTimerStart = chrono::steady_clock::now();
+    _gameTimerStart = _clock->now();
     _gameTimerRunning = true;
 }
 
 void GameState::pauseGameTimer() {
     if (_gameTimerRunning) {
-        _gameElapsedAccum += chrono::duration<double>(chrono::steady_clock::now() - _gameTimerStart).count();
+        _gameElapsedAccum += _clock->now() - _gameTimerStart;
         _gameTimerRunning = false;
     }
 }
 
 void GameState::resumeGameTimer() {
     if (!_gameTimerRunning) {
-        _gameTimerStart = chrono::steady_clock::now();
+        _gameTimerStart = _clock->now();
         _gameTimerRunning = true;
     }
 }
 
 double GameState::gameElapsed() const {
     double total = _gameElapsedAccum;
-    if (_gameTimerRunning) total += chrono::duration<double>(chrono::steady_clock::now() - _gameTimerStart).count();
+    if (_gameTimerRunning) total += _clock->now() - _gameTimerStart;
     return total;
 }
 
@@ -1,14 +1,18 @@
 #pragma once
 
 #include <string>
-#include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <array>
 #include <cstdint>
 
 #include "Constants.h"
+#include "GameMatrix.h"
+#include "GameTimers.h"
 #include "GameTypes.h"
+#include "PieceQueue.h"
+#include "Rng.h"
 #include "SecureValue.h"
 #include "Tetrimino.h"
 
@@ -29,6 +33,7 @@ struct HighScoreRecord {
     bool ghostEnabled{true};
     bool holdEnabled{true};
     int previewCount{6};
+    uint64_t seed{}; // reproduces the piece sequence
 };
 
 struct GameConfig {
@@ -36,10 +41,22 @@ struct GameConfig {
     GameVariant variant = GameVariant::Marathon;
     bool ghostEnabled = true;
     bool holdEnabled = true;
+    bool sonicDrop = false; // soft drop moves the piece straight to the stack without locking
     int previewCount = 6;
     int startingLevel = 1;
     double timeLimit = -1;
     bool showGoal = true;
+    RandomizerType randomizer = RandomizerType::SevenBag;
+    uint64_t seed = 0; // 0 = fresh seed for every game
+    bool practice = false; // undo key enabled; the game is neither ranked nor recorded
+};
+
+// Audio settings persisted alongside the game options. The core only stores
+// them; the Tetrominos facade applies them to the SoundEngine.
+struct SoundOptions {
+    int musicVolume{5};  // 0-10 steps
+    int effectVolume{5}; // 0-10 steps
+    int soundtrackMode{};
 };
 
 using HighScoreTable = std::array<std::vector<HighScoreRecord>, VARIANT_COUNT>;
@@ -66,11 +83,11 @@ struct LockDownState {
 };
 
 struct PieceState {
-    std::vector<std::unique_ptr<Tetrimino>> bag;
-    unsigned int bagIndex{};
-    Tetrimino *current{};
-    Tetrimino *hold{};
+    PieceQueue queue;
+    std::optional<Tetrimino> current;
+    std::optional<Tetrimino> hold;
     bool isNewHold{};
+    int64_t fallProgress{}; // gravity owed to the current piece, kGravityOne per row
 };
 
 struct FrameFlags {
@@ -82,17 +99,41 @@ struct FrameFlags {
     bool isStarted{};
 };
 
+// Everything the simulation needs to resume a game from one tick: fixed-size,
+// so taking one is a few kilobytes of copying and no allocation. GameState
+// fills the game data; the controller adds its timers.
+struct GameSnapshot {
+    GameMatrix matrix;
+    Stats stats;
+    LockDownState lockDown;
+    PieceQueue::Snapshot queue;
+    std::optional<Tetrimino> current;
+    std::optional<Tetrimino> hold;
+    bool isNewHold{};
+    int64_t fallProgress{};
+    FrameFlags flags;
+    GamePhase phase{};
+    uint64_t clearingRows{}; // lineClear.rows as a bitmask
+    Rng rng;
+    uint64_t seed{};
+    double gameElapsed{};
+    GameTimers::Snapshot timers;
+};
+
+class Clock;
+struct SimState;
+
 class GameState {
 public:
-    GameState();
+    explicit GameState(const Clock &clock);
     ~GameState();
 
-    void loadHighscore();
-    void saveHighscore();
-    void loadOptions();
-    void saveOptions() const;
-    [[nodiscard]] Tetrimino *peekTetrimino() const;
-    [[nodiscard]] std::vector<const Tetrimino *> peekTetriminos(size_t count) const;
+    // The caller names the files; the core never looks up the data directory
+    void loadHighscore(const std::string &path);
+    void saveHighscore(const std::string &path);
+    void loadOptions(const std::string &path);
+    void saveOptions(const std::string &path) const;
+    [[nodiscard]] std::vector<PieceType> peekPieces(size_t count) const;
 
     void setShouldExit(const bool v) { _shouldExit = v; }
     void setStartingLevel(int level);
@@ -109,6 +150,28 @@ public:
     [[nodiscard]] const HighScoreTable &allHighscores() const { return _highscores; }
     [[nodiscard]] bool shouldExit() const { return _shouldExit; }
 
+    // Rows the current piece can fall (0 without one), cached until the piece
+    // moves or the matrix changes.
+    [[nodiscard]] int dropDistance() const;
+    // Zobrist hash of the matrix occupancy, the next PieceQueue::kHashedPieces
+    // pieces and the held piece. Each part is kept up to date as it changes,
+    // so this is two XORs.
+    [[nodiscard]] uint64_t hash() const;
+
+    // Copies the simulation state out and back. UI-only state (line-clear
+    // texts, the hard-drop trail, pending sounds) is not kept: restore()
+    // clears it and marks the state dirty. The game timer resumes from the
+    // snapshot's elapsed time.
+    void snapshot(GameSnapshot &out) const;
+    void restore(const GameSnapshot &snapshot);
+    // Writes a SimState back over the hot state: the matrix (every filled cell
+    // grey), stats, pieces, the next SimState::kQueueLength queued pieces, lock
+    // down, flags and phase. Everything a SimState leaves out is kept, so the
+    // game steps on as the captured one did when the rest (the randomizer, the
+    // game timer, the controller's timers) is from the same tick: a search
+    // restores each position into a state it restored a GameSnapshot into.
+    void restore(const SimState &sim);
+
     void markDirty() { _isDirty = true; }
     [[nodiscard]] bool isDirty() const { return _isDirty; }
     void clearDirty() { _isDirty = false; }
@@ -119,6 +182,7 @@ public:
     void startGameTimer();
     void pauseGameTimer();
     void resumeGameTimer();
+    [[nodiscard]] bool gameTimerRunning() const { return _gameTimerRunning; }
     [[nodiscard]] double gameElapsed() const;
     [[nodiscard]] double displayTime() const;
     [[nodiscard]] int minutesElapsed() const { return static_cast<int>(gameElapsed() / 60); }
@@ -129,6 +193,7 @@ public:
 
     // Public sub-structs
     GameConfig config;
+    std::optional<SoundOptions> sound; // set by loadOptions() when the file has audio settings
     Stats stats;
     LockDownState lockDown;
     PieceState pieces;
@@ -137,15 +202,27 @@ public:
     GamePhase phase = GamePhase::Falling;
     LineClearState lineClear;
     HardDropTrail hardDropTrail;
+    Rng rng;         // all game randomness draws from this
+    uint64_t seed{}; // what rng was seeded with for the current game
 
 private:
+    struct DropCache {
+        PieceType type{};
+        Rotation rotation{};
+        Vector2i position;
+        uint32_t matrixVersion{};
+        int distance{-1}; // -1 until first computed
+    };
+
     bool _isDirty{};
     bool _shouldExit{};
     std::string _playerName;
     HighScoreTable _highscores; // per-variant, each sorted by score desc, max 10
     std::vector<GameSound> _pendingSounds;
+    mutable DropCache _drop;
 
-    std::chrono::steady_clock::time_point _gameTimerStart{};
+    const Clock *_clock;
+    double _gameTimerStart{};
     double _gameElapsedAccum{};
     bool _gameTimerRunning{};
 };
@@ -0,0 +1,45 @@
+#include "GameTimers.h"
+
+#include <cmath>
+
+#include "Clock.h"
+
+using namespace std;
+
+static_assert(static_cast<size_t>(GameTimer::HardDropTrail) + 1 == GAME_TIMER_COUNT);
+
+GameTimers::GameTimers(const Clock &clock) : _clock(clock) {
+}
+
+// The facade's clock already sits on the tick grid (tick / rate), so rounding
+// recovers the tick number exactly.
+void GameTimers::sample() {
+    _now = llround(_clock.now() * _tickRate);
+}
+
+void GameTimers::resetTimer(const GameTimer id, const int64_t ticks) {
+    _starts[static_cast<size_t>(id)] = _now - ticks;
+    _running |= bit(id);
+}
+
+int64_t GameTimers::getTicks(const GameTimer id) const {
+    if (!exist(id)) return 0;
+    return _now - _starts[static_cast<size_t>(id)];
+}
+
+int64_t GameTimers::deadline(const GameTimer id, const int64_t ticks) const {
+    if (!exist(id)) return NO_DEADLINE;
+    return _starts[static_cast<size_t>(id)] + ticks;
+}
+
+GameTimers::Snapshot GameTimers::snapshot() const {
+    Snapshot snapshot;
+    for (size_t i = 0; i < GAME_TIMER_COUNT; i++) snapshot.elapsed[i] = _now - _starts[i];
+    snapshot.running = _running;
+    return snapshot;
+}
+
+void GameTimers::restore(const Snapshot &snapshot) {
+    for (size_t i = 0; i < GAME_TIMER_COUNT; i++) _starts[i] = _now - snapshot.elapsed[i];
+    _running = snapshot.running;
+}
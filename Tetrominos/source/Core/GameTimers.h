@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Constants.h"
+
+class Clock;
+
+// The game's timers, one fixed slot each.
+enum class GameTimer : uint8_t { Fall, AutorepeatLeft, AutorepeatRight, LockDown, Generation, Animate, HardDropTrail };
+inline constexpr size_t GAME_TIMER_COUNT = 7;
+inline constexpr int64_t NO_DEADLINE = INT64_MAX; // a deadline tick that never comes
+
+// Game timers (fall, lock-down, autorepeat, ...) counted in whole ticks of an
+// injected Clock instead of the KonsoleGE Timer singleton. sample() reads the
+// clock once per tick and rounds it to the tick grid; every start and query
+// until the next sample uses that tick, so a tick sees one consistent "now",
+// never touches a map, and compares integers against TickTimings.
+class GameTimers {
+public:
+    // Elapsed ticks of the running timers, so a restore resumes them relative to the tick it happens on.
+    struct Snapshot {
+        std::array<int64_t, GAME_TIMER_COUNT> elapsed{};
+        uint8_t running{};
+    };
+
+    explicit GameTimers(const Clock &clock);
+
+    void setTickRate(int tickRate) { _tickRate = tickRate; }
+    void sample();
+
+    void startTimer(GameTimer id) { resetTimer(id); }
+    void resetTimer(GameTimer id, int64_t ticks = 0); // as if started `ticks` ago
+    void stopTimer(GameTimer id) { _running &= static_cast<uint8_t>(~bit(id)); }
+    [[nodiscard]] int64_t getTicks(GameTimer id) const; // 0 when not running
+    [[nodiscard]] bool exist(const GameTimer id) const { return (_running & bit(id)) != 0; }
+    // The tick at which getTicks(id) reaches `ticks`; NO_DEADLINE when not running.
+    [[nodiscard]] int64_t deadline(GameTimer id, int64_t ticks) const;
+    [[nodiscard]] int64_t now() const { return _now; } // the sampled tick
+
+    [[nodiscard]] Snapshot snapshot() const;
+    void restore(const Snapshot &snapshot);
+
+private:
+    static_assert(GAME_TIMER_COUNT <= 8, "_running holds one bit per timer");
+
+    static constexpr uint8_t bit(const GameTimer id) { return static_cast<uint8_t>(1u << static_cast<unsigned>(id)); }
+
+    const Clock &_clock;
+    int _tickRate{DEFAULT_TICK_RATE};
+    int64_t _now{};
+    std::array<int64_t, GAME_TIMER_COUNT> _starts{};
+    uint8_t _running{};
+};
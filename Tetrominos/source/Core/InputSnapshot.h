@@ -1,9 +1,31 @@
 #pragma once
 
-enum class Action { Left, Right, SoftDrop, HardDrop, RotateCW, RotateCCW, Hold, Pause, Select, Count };
+enum class Action { Left, Right, SoftDrop, HardDrop, RotateCW, RotateCCW, Hold, Undo, Pause, Select, Count };
 
 struct InputSnapshot {
     bool left{}, right{}, softDrop{}, hardDrop{};
     bool rotateCW{}, rotateCCW{};
     bool hold{}, pause{};
+    bool undo{}; // practice games only; not part of replays
 };
+
+// Keys pressed at once and the session clock time they were read at.
+struct KeyEvent {
+    double time{};
+    InputSnapshot keys;
+};
+
+// The actions active in either snapshot: keys pressed together.
+inline InputSnapshot combine(const InputSnapshot &a, const InputSnapshot &b) {
+    InputSnapshot both;
+    both.left = a.left || b.left;
+    both.right = a.right || b.right;
+    both.softDrop = a.softDrop || b.softDrop;
+    both.hardDrop = a.hardDrop || b.hardDrop;
+    both.rotateCW = a.rotateCW || b.rotateCW;
+    both.rotateCCW = a.rotateCCW || b.rotateCCW;
+    both.hold = a.hold || b.hold;
+    both.pause = a.pause || b.pause;
+    both.undo = a.undo || b.undo;
+    return both;
+}
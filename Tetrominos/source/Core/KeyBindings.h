@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Input.h"
+#include "InputSnapshot.h"
+
+struct KeyBinding {
+    Action action;
+    KeyCode key;
+};
+
+constexpr KeyCode letterKey(const char letter) {
+    return static_cast<KeyCode>(static_cast<int>(letter));
+}
+
+// Default keys of every action, shared by the console (ConsoleInput) and
+// remote terminals (RemoteInput). An action can have several keys.
+inline constexpr KeyBinding kDefaultKeyBindings[] = {
+    {Action::Left, KeyCode::ArrowLeft},       {Action::Left, letterKey('A')},      {Action::Left, KeyCode::Numpad4},
+    {Action::Right, KeyCode::ArrowRight},     {Action::Right, letterKey('D')},     {Action::Right, KeyCode::Numpad6},
+    {Action::SoftDrop, KeyCode::ArrowDown},   {Action::SoftDrop, letterKey('S')},  {Action::SoftDrop, KeyCode::Numpad2},
+    {Action::HardDrop, letterKey(' ')},       {Action::HardDrop, KeyCode::Numpad8},
+    {Action::RotateCW, KeyCode::ArrowUp},     {Action::RotateCW, letterKey('X')},  {Action::RotateCW, KeyCode::Numpad1},
+    {Action::RotateCW, KeyCode::Numpad5},     {Action::RotateCW, KeyCode::Numpad9},
+    {Action::RotateCCW, letterKey('Z')},      {Action::RotateCCW, KeyCode::Numpad3},
+    {Action::RotateCCW, KeyCode::Numpad7},
+    {Action::Hold, letterKey('C')},           {Action::Hold, KeyCode::Numpad0},
+    {Action::Undo, letterKey('U')},
+    {Action::Pause, KeyCode::Escape},         {Action::Pause, KeyCode::F1},
+    {Action::Select, KeyCode::Enter},
+};
+
+// Sets the snapshot field of a game action; Select is menu-only and ignored.
+inline void setAction(InputSnapshot &snapshot, const Action action, const bool active) {
+    switch (action) {
+        case Action::Left: snapshot.left = active; break;
+        case Action::Right: snapshot.right = active; break;
+        case Action::SoftDrop: snapshot.softDrop = active; break;
+        case Action::HardDrop: snapshot.hardDrop = active; break;
+        case Action::RotateCW: snapshot.rotateCW = active; break;
+        case Action::RotateCCW: snapshot.rotateCCW = active; break;
+        case Action::Hold: snapshot.hold = active; break;
+        case Action::Undo: snapshot.undo = active; break;
+        case Action::Pause: snapshot.pause = active; break;
+        case Action::Select:
+        case Action::Count: break;
+    }
+}
@@ -0,0 +1,113 @@
+#include "KeyDecoder.h"
+
+#include <cctype>
+
+#include "KeyBindings.h"
+
+using namespace std;
+
+static constexpr unsigned char kEscape = 0x1B;
+static constexpr unsigned char kTelnetIac = 0xFF;
+static constexpr unsigned char kTelnetSubnegotiation = 0xFA;
+static constexpr unsigned char kTelnetSubnegotiationEnd = 0xF0;
+static constexpr unsigned char kTelnetWill = 0xFB; // WILL, WONT, DO and DONT take an option byte
+
+static constexpr KeyCode kNumpadDigits[] = {KeyCode::Numpad0, KeyCode::Numpad1, KeyCode::Numpad2, KeyCode::Numpad3,
+                                            KeyCode::Numpad4, KeyCode::Numpad5, KeyCode::Numpad6, KeyCode::Numpad7,
+                                            KeyCode::Numpad8, KeyCode::Numpad9};
+
+void KeyDecoder::receive(const string_view bytes) {
+    if (_pending.empty()) {
+        _pending.assign(bytes.substr(decode(bytes)));
+    } else {
+        _pending += bytes;
+        _pending.erase(0, decode(_pending));
+    }
+    if (_pending.size() > kMaxPending) _pending.clear();
+}
+
+void KeyDecoder::flush() {
+    if (_pending.size() == 1 && static_cast<unsigned char>(_pending[0]) == kEscape) press(KeyCode::Escape);
+    _pending.clear();
+}
+
+size_t KeyDecoder::decode(const string_view bytes) {
+    size_t i = 0;
+    while (i < bytes.size()) {
+        const auto byte = static_cast<unsigned char>(bytes[i]);
+        const string_view rest = bytes.substr(i);
+        if (byte == kTelnetIac || byte == kEscape) {
+            const size_t length = byte == kEscape ? decodeEscape(rest) : skipTelnetCommand(rest);
+            if (length == 0) break;
+            i += length;
+            continue;
+        }
+
+        i++;
+        if (byte == 0x03 || byte == 0x04) {
+            _interrupted = true;
+        } else if (byte == '\r' || byte == '\n') {
+            press(KeyCode::Enter);
+        } else if (isdigit(byte)) {
+            press(letterKey(static_cast<char>(byte)));
+            press(kNumpadDigits[byte - '0']);
+        } else if (byte >= ' ' && byte < 0x7F) {
+            press(letterKey(static_cast<char>(toupper(byte))));
+        }
+    }
+    return i;
+}
+
+void KeyDecoder::press(const KeyCode key) {
+    if (_keys.size() < kMaxKeys) _keys.push_back(key);
+}
+
+size_t KeyDecoder::decodeEscape(const string_view bytes) {
+    if (bytes.size() < 2) return 0;
+    if (bytes[1] != '[' && bytes[1] != 'O') {
+        press(KeyCode::Escape);
+        return 1;
+    }
+
+    // CSI and SS3 sequences end with a byte in '@'..'~'; only the game's keys are decoded.
+    size_t end = 2;
+    while (end < bytes.size() && (bytes[end] < '@' || bytes[end] > '~')) end++;
+    if (end == bytes.size()) return 0;
+
+    if (end == 2) {
+        switch (bytes[2]) {
+            case 'A': press(KeyCode::ArrowUp); break;
+            case 'B': press(KeyCode::ArrowDown); break;
+            case 'C': press(KeyCode::ArrowRight); break;
+            case 'D': press(KeyCode::ArrowLeft); break;
+            case 'P': press(KeyCode::F1); break;
+            default: break;
+        }
+    }
+    return end + 1;
+}
+
+size_t KeyDecoder::skipTelnetCommand(const string_view bytes) {
+    if (bytes.size() < 2) return 0;
+    const auto command = static_cast<unsigned char>(bytes[1]);
+    if (command == kTelnetSubnegotiation) {
+        for (size_t i = 2; i + 1 < bytes.size(); i++) {
+            if (static_cast<unsigned char>(bytes[i]) == kTelnetIac &&
+                static_cast<unsigned char>(bytes[i + 1]) == kTelnetSubnegotiationEnd)
+                return i + 2;
+        }
+        return 0;
+    }
+    if (command >= kTelnetWill && command != kTelnetIac) return bytes.size() < 3 ? 0 : 3;
+    return 2;
+}
+
+InputSnapshot KeyDecoder::take() {
+    InputSnapshot snapshot;
+    for (const KeyCode key : _keys) {
+        for (const auto &binding : kDefaultKeyBindings)
+            if (binding.key == key) setAction(snapshot, binding.action, true);
+    }
+    _keys.clear();
+    return snapshot;
+}
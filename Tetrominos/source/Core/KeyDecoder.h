@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Input.h"
+#include "InputSnapshot.h"
+
+// Decodes the bytes of a raw-mode terminal the way the Linux console does
+// (InputLinux): ANSI escape sequences, letters (stored uppercase), digits
+// (also reported as their numpad key), space, Enter and a lone Escape. A
+// terminal reports key presses only, never releases. Telnet commands are
+// skipped. A read can end inside a sequence, so its unfinished tail is kept
+// and decoded with the next bytes; a lone Escape is only reported once the
+// next bytes show it starts no sequence, or by flush() when none come. Used
+// by the console's reader thread (ConsoleInput) and by remote players
+// (RemoteInput).
+class KeyDecoder {
+public:
+    static constexpr size_t kMaxKeys = 64; // keys held between two takes; a flood beyond this is dropped
+    static constexpr size_t kMaxPending = 256; // an unfinished sequence longer than this is dropped
+    static constexpr double kSequenceWait = 0.05; // seconds to wait for the rest of a sequence, as Platform::getKey
+
+    void receive(std::string_view bytes);
+    // Keys received since the last take() or discard().
+    [[nodiscard]] const std::vector<KeyCode> &keys() const { return _keys; }
+    void discard() { _keys.clear(); }
+    // The actions of the keys received, through kDefaultKeyBindings; clears them.
+    [[nodiscard]] InputSnapshot take();
+    // Ctrl-C or Ctrl-D was received.
+    [[nodiscard]] bool interrupted() const { return _interrupted; }
+    // The bytes received end in an unfinished escape sequence or telnet command.
+    [[nodiscard]] bool pending() const { return !_pending.empty(); }
+    // The rest of the unfinished sequence is not coming: a lone Escape is the
+    // Escape key, anything else is dropped.
+    void flush();
+    [[nodiscard]] size_t memoryBytes() const { return _keys.capacity() * sizeof(KeyCode) + _pending.capacity(); }
+
+private:
+    // Decodes bytes up to an unfinished sequence at their end and returns how many were used.
+    size_t decode(std::string_view bytes);
+    // Length of the escape sequence at the start of bytes, adding its key if
+    // known, or 0 if it is not finished yet.
+    size_t decodeEscape(std::string_view bytes);
+    // Length of the telnet command at the start of bytes, or 0 if it is not finished yet.
+    static size_t skipTelnetCommand(std::string_view bytes);
+    void press(KeyCode key);
+
+    std::vector<KeyCode> _keys;
+    std::string _pending; // the unfinished sequence at the end of the last bytes
+    bool _interrupted{};
+};
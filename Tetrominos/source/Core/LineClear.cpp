@@ -2,25 +2,34 @@
 
 #include "Color.h"
 #include "Constants.h"
+#include "GameTimers.h"
 #include "ScoringRule.h"
-#include "Timer.h"
+#include "TickTimings.h"
 
 using namespace std;
 
-static constexpr auto kAnimate = "animate";
-
-static constexpr double kAnimateDuration = 0.4;
-static constexpr double kFlashInterval = 0.1;
+template <class Scoring, class Goal, class Variant>
+BasicLineClear<Scoring, Goal, Variant>::BasicLineClear(GameTimers &timers, const TickTimings &timings,
+                                                       Scoring *scoringRule, Goal *goalPolicy, Variant *variantRule)
+    : _timer(timers), _timings(timings), _scoringRule(scoringRule), _goalPolicy(goalPolicy), _variantRule(variantRule) {
+}
 
-LineClear::LineClear(Timer &timer, ScoringRule *scoringRule, GoalPolicy *goalPolicy, VariantRule *variantRule)
-    : _timer(timer), _scoringRule(scoringRule), _goalPolicy(goalPolicy), _variantRule(variantRule) {
+template <class Scoring, class Goal, class Variant>
+void BasicLineClear<Scoring, Goal, Variant>::resetTimers() const {
+    _timer.stopTimer(GameTimer::Animate);
 }
 
-void LineClear::resetTimers() const {
-    _timer.stopTimer(kAnimate);
+template <class Scoring, class Goal, class Variant>
+int64_t BasicLineClear<Scoring, Goal, Variant>::nextDeadline(const GameState &state) const {
+    const int64_t next = _timer.now() + 1;
+    if (state.phase != GamePhase::Animate || !_timer.exist(GameTimer::Animate)) return next;
+
+    const int64_t toggle = (_timer.getTicks(GameTimer::Animate) / _timings.flashInterval + 1) * _timings.flashInterval;
+    return max(_timer.deadline(GameTimer::Animate, min(toggle, _timings.animateDuration)), next);
 }
 
-void LineClear::stepPattern(GameState &state) const {
+template <class Scoring, class Goal, class Variant>
+void BasicLineClear<Scoring, Goal, Variant>::stepPattern(GameState &state) const {
     if (auto rows = detectFullRows(state); !rows.empty()) {
         state.lineClear.rows = std::move(rows);
         const int linesCleared = static_cast<int>(state.lineClear.rows.size());
@@ -69,31 +78,33 @@ void LineClear::stepPattern(GameState &state) const {
     }
 }
 
-void LineClear::stepAnimate(GameState &state) const {
-    if (!_timer.exist(kAnimate)) {
-        _timer.startTimer(kAnimate);
+template <class Scoring, class Goal, class Variant>
+void BasicLineClear<Scoring, Goal, Variant>::stepAnimate(GameState &state) const {
+    if (!_timer.exist(GameTimer::Animate)) {
+        _timer.startTimer(GameTimer::Animate);
         state.lineClear.flashOn = true;
         state.markDirty();
     }
 
-    const double elapsed = _timer.getSeconds(kAnimate);
+    const int64_t elapsed = _timer.getTicks(GameTimer::Animate);
 
-    if (elapsed >= kAnimateDuration) {
-        _timer.stopTimer(kAnimate);
+    if (elapsed >= _timings.animateDuration) {
+        _timer.stopTimer(GameTimer::Animate);
         state.lineClear.flashOn = false;
         state.phase = GamePhase::Eliminate;
         state.markDirty();
         return;
     }
 
-    if (const bool shouldBeOn = static_cast<int>(elapsed / kFlashInterval) % 2 == 0;
+    if (const bool shouldBeOn = (elapsed / _timings.flashInterval) % 2 == 0;
         shouldBeOn != state.lineClear.flashOn) {
         state.lineClear.flashOn = shouldBeOn;
         state.markDirty();
     }
 }
 
-void LineClear::stepEliminate(GameState &state) const {
+template <class Scoring, class Goal, class Variant>
+void BasicLineClear<Scoring, Goal, Variant>::stepEliminate(GameState &state) const {
     const int linesCleared = static_cast<int>(state.lineClear.rows.size());
     eliminateRows(state, state.lineClear.rows);
     awardScore(state, linesCleared);
@@ -109,31 +120,30 @@ void LineClear::stepEliminate(GameState &state) const {
     state.markDirty();
 }
 
-vector<int> LineClear::detectFullRows(const GameState &state) {
+template <class Scoring, class Goal, class Variant>
+vector<int> BasicLineClear<Scoring, Goal, Variant>::detectFullRows(const GameState &state) {
+    // The matrix tracks full rows as it is filled; only visible rows are cleared.
+    constexpr uint64_t kVisibleRows = ((uint64_t{1} << VISIBLE_ROWS) - 1) << MATRIX_START;
+    uint64_t full = state.matrix.fullRows() & kVisibleRows;
+
     vector<int> rows;
-    for (int i = MATRIX_END; i >= MATRIX_START; i--) {
-        bool full = true;
-        for (int j = 0; j < BOARD_WIDTH; j++) {
-            if (state.matrix[i][j] == 0) {
-                full = false;
-                break;
-            }
+    for (int i = MATRIX_END; full != 0; i--) {
+        if (const uint64_t bit = uint64_t{1} << i; full & bit) {
+            rows.push_back(i);
+            full &= ~bit;
         }
-        if (full) rows.push_back(i);
     }
     return rows;
 }
 
-void LineClear::eliminateRows(GameState &state, const vector<int> &rows) {
+template <class Scoring, class Goal, class Variant>
+void BasicLineClear<Scoring, Goal, Variant>::eliminateRows(GameState &state, const vector<int> &rows) {
     // rows are sorted descending (the highest index first) from detectFullRows
-    for (const int r : rows)
-        state.matrix.erase(state.matrix.begin() + r);
-
-    for (size_t i = 0; i < rows.size(); i++)
-        state.matrix.push_front(MatrixRow{});
+    state.matrix.eliminateRows(rows);
 }
 
-void LineClear::awardScore(GameState &state, const int linesCleared) const {
+template <class Scoring, class Goal, class Variant>
+void BasicLineClear<Scoring, Goal, Variant>::awardScore(GameState &state, const int linesCleared) const {
     if (linesCleared == 4) state.stats.quad++;
     if (state.flags.lastMoveIsTSpin || state.flags.lastMoveIsMiniTSpin) state.stats.tSpins++;
 
@@ -171,3 +181,9 @@ void LineClear::awardScore(GameState &state, const int linesCleared) const {
     else
         state.stats.goal -= linesCleared;
 }
+
+template class BasicLineClear<ScoringRule, GoalPolicy, VariantRule>;
+template class BasicLineClear<GuidelineScoringRule, VariableGoal, MarathonVariant>;
+template class BasicLineClear<GuidelineScoringRule, VariableGoal, SprintVariant>;
+template class BasicLineClear<GuidelineScoringRule, VariableGoal, UltraVariant>;
+template class BasicLineClear<GuidelineScoringRule, VariableGoal, MasterVariant>;
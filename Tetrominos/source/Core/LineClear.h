@@ -6,26 +6,37 @@
 #include "GoalPolicy.h"
 #include "VariantRule.h"
 
+class GameTimers;
 class ScoringRule;
-class Timer;
+struct TickTimings;
 
-class LineClear {
+// Pattern/Animate/Eliminate phases. Like BasicPieceMovement, the policy types
+// are either the abstract rule interfaces or final classes of a fixed rule set,
+// and the definitions in LineClear.cpp are instantiated for each.
+template <class Scoring, class Goal, class Variant>
+class BasicLineClear {
 public:
-    LineClear(Timer &timer, ScoringRule *scoringRule, GoalPolicy *goalPolicy, VariantRule *variantRule);
+    BasicLineClear(GameTimers &timers, const TickTimings &timings, Scoring *scoringRule, Goal *goalPolicy,
+                   Variant *variantRule);
 
     void stepPattern(GameState &state) const;
     void stepAnimate(GameState &state) const;
     void stepEliminate(GameState &state) const;
     void resetTimers() const;
-    void setVariantRule(VariantRule *rule) { _variantRule = rule; }
+    // The next flash toggle or the end of the animation; the other phases take one step each.
+    [[nodiscard]] int64_t nextDeadline(const GameState &state) const;
+    void setVariantRule(Variant *rule) { _variantRule = rule; }
 
 private:
     [[nodiscard]] static std::vector<int> detectFullRows(const GameState &state);
     static void eliminateRows(GameState &state, const std::vector<int> &rows);
     void awardScore(GameState &state, int linesCleared) const;
 
-    Timer &_timer;
-    ScoringRule *_scoringRule;
-    GoalPolicy *_goalPolicy;
-    VariantRule *_variantRule;
+    GameTimers &_timer;
+    const TickTimings &_timings;
+    Scoring *_scoringRule;
+    Goal *_goalPolicy;
+    Variant *_variantRule;
 };
+
+using LineClear = BasicLineClear<ScoringRule, GoalPolicy, VariantRule>;
@@ -0,0 +1,211 @@
+#include "MoveGenerator.h"
+
+#include "GameState.h"
+
+using namespace std;
+
+namespace {
+
+// Rotation whose cells equal this one's after a (row, column) shift. Pieces
+// with symmetric facings (O, I, S, Z) alias to an earlier rotation; the rest
+// alias to themselves.
+struct RotationAlias {
+    Rotation rotation;
+    int row;
+    int column;
+};
+
+constexpr bool containsMino(const FacingMinos &minos, const PieceOffset &offset) {
+    for (const auto &mino : minos)
+        if (mino.row == offset.row && mino.column == offset.column) return true;
+    return false;
+}
+
+// True when a piece in facing a at (r, c) covers the same cells as facing b at (r + row, c + column).
+constexpr bool sameCells(const FacingMinos &a, const FacingMinos &b, const int row, const int column) {
+    for (const auto &mino : a)
+        if (!containsMino(b, {mino.row - row, mino.column - column})) return false;
+    return true;
+}
+
+constexpr PerPiece<PerRotation<RotationAlias>> makeRotationAliases() {
+    PerPiece<PerRotation<RotationAlias>> aliases{};
+    for (size_t type = 0; type < PIECE_TYPE_COUNT; type++) {
+        for (size_t rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+            aliases[type][rotation] = {static_cast<Rotation>(rotation), 0, 0};
+            bool found = false;
+            for (size_t earlier = 0; earlier < rotation && !found; earlier++)
+                for (int row = -2; row <= 2 && !found; row++)
+                    for (int column = -2; column <= 2 && !found; column++)
+                        if (sameCells(kPieceMinos[type][rotation], kPieceMinos[type][earlier], row, column)) {
+                            aliases[type][rotation] = {static_cast<Rotation>(earlier), row, column};
+                            found = true;
+                        }
+        }
+    }
+    return aliases;
+}
+
+constexpr PerPiece<PerRotation<RotationAlias>> kRotationAliases = makeRotationAliases();
+
+static_assert(kRotationAliases[static_cast<size_t>(PieceType::O)][3].rotation == Rotation::North);
+static_assert(kRotationAliases[static_cast<size_t>(PieceType::T)][2].rotation == Rotation::South);
+
+// First row holding a mino, BOARD_HEIGHT for an empty matrix.
+int stackTop(const GameMatrix &matrix) {
+    for (int row = 0; row < BOARD_HEIGHT; row++)
+        if (matrix.rowMask(row) != GameMatrix::kEmptyRow) return row;
+    return BOARD_HEIGHT;
+}
+
+// Column occupancy for the fit table: bit (row + kRowBias) of a column is set
+// when that cell is blocked. Rows outside the matrix and columns outside the
+// walls are always blocked.
+constexpr int kRowBias = 2;
+constexpr int kColumnBias = 4;
+constexpr uint64_t kOutsideRows = ((uint64_t{1} << kRowBias) - 1) | (~uint64_t{0} << (BOARD_HEIGHT + kRowBias));
+constexpr uint64_t kPieceRows = (uint64_t{1} << (BOARD_HEIGHT + 2)) - 1;
+
+} // namespace
+
+void MoveGenerator::buildFitTable(const GameMatrix &matrix) {
+    array<uint64_t, BOARD_WIDTH + 2 * kColumnBias + 2> occupied{};
+    occupied.fill(~uint64_t{0});
+    for (int column = 0; column < BOARD_WIDTH; column++)
+        occupied[static_cast<size_t>(column + kColumnBias)] = kOutsideRows;
+    for (int row = stackTop(matrix); row < BOARD_HEIGHT; row++) {
+        const uint16_t mask = matrix.rowMask(row);
+        for (int column = 0; column < BOARD_WIDTH; column++)
+            if (mask & GameMatrix::columnBit(column))
+                occupied[static_cast<size_t>(column + kColumnBias)] |= uint64_t{1} << (row + kRowBias);
+    }
+
+    // A mino at (r, c) of a piece at row p lands on cell row p + r, which is
+    // bit p + r + kRowBias of its column; shifting right by r + 1 lines that up
+    // with the piece's own bit p + 1.
+    for (size_t rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+        const FacingMinos &minos = pieceMinos(_type, static_cast<Rotation>(rotation));
+        for (int column = -2; column < kColumns - 2; column++) {
+            uint64_t blocked = 0;
+            for (const auto &mino : minos)
+                blocked |= occupied[static_cast<size_t>(column + mino.column + kColumnBias)] >> (mino.row + 1);
+            _fitRows[rotation][static_cast<size_t>(column + 2)] = ~blocked & kPieceRows;
+        }
+    }
+}
+
+bool MoveGenerator::fits(const Rotation rotation, const int row, const int column) const {
+    if (column < -2 || column >= kColumns - 2 || row < -1 || row >= kRows - 1) return false;
+    return (_fitRows[static_cast<size_t>(rotation)][static_cast<size_t>(column + 2)] >> (row + 1)) & 1;
+}
+
+int MoveGenerator::rotate(const Pose &pose, const Direction direction, Pose &result) const {
+    const Rotation newRotation = rotated(pose.rotation, direction);
+    const FacingKicks &kicks = pieceKicks(_type, pose.rotation);
+    for (int i = 0; i < KICK_COUNT; i++) {
+        const Kick &kick = kicks[static_cast<size_t>(i)];
+        if (!kick.exists) continue;
+        const PieceOffset &translation = direction == Direction::Left ? kick.left : kick.right;
+        if (fits(newRotation, pose.row + translation.row, pose.column + translation.column)) {
+            result = {newRotation, pose.row + translation.row, pose.column + translation.column};
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+
+size_t MoveGenerator::poseIndex(const Rotation rotation, const int row, const int column) {
+    return (static_cast<size_t>(rotation) * kRows + static_cast<size_t>(row + 1)) * kColumns +
+           static_cast<size_t>(column + 2);
+}
+
+// Records the pose if it rests on the stack, and queues it the first time it
+// is seen. Non-T pieces only need the resting test on a pose's first arrival;
+// a T pose is re-tested on every arrival since the spin depends on the path.
+// rotationPoint is the kick that produced the pose, 0 for a move.
+void MoveGenerator::arrive(const GameMatrix &matrix, const Pose &pose, const int rotationPoint,
+                           vector<Placement> &placements) {
+    const size_t index = poseIndex(pose);
+    const bool isNew = !_visited[index];
+
+    if ((isNew || _tracksSpin) && isResting(pose)) {
+        const Tetrimino piece(_type, pose.rotation, Vector2i(pose.row, pose.column),
+                              rotationPoint > 0 ? rotationPoint : -1);
+        SpinType spin = SpinType::None;
+        if (rotationPoint > 0 && piece.canTSpin()) {
+            if (piece.checkTSpin(matrix))
+                spin = SpinType::Full;
+            else if (piece.checkMiniTSpin(matrix))
+                spin = SpinType::Mini;
+        }
+        addPlacement(piece, spin, placements);
+    }
+
+    if (isNew) {
+        _visited.set(index);
+        _queue[_queueSize++] = pose;
+    }
+}
+
+void MoveGenerator::addPlacement(const Tetrimino &piece, const SpinType spin, vector<Placement> &placements) {
+    const Vector2i position = piece.getPosition();
+    const RotationAlias &alias =
+        kRotationAliases[static_cast<size_t>(piece.getType())][static_cast<size_t>(piece.getRotation())];
+    const size_t index = poseIndex(alias.rotation, position.row + alias.row, position.column + alias.column);
+
+    auto &placed = _placed[static_cast<size_t>(spin)];
+    if (placed[index]) return;
+    placed.set(index);
+    placements.push_back({piece, spin});
+}
+
+// Breadth-first search over (rotation, row, column) poses. Every pose is
+// expanded once; resting poses are recorded on arrival, so a T pose reached both
+// by a plain move and by a kick that scores a spin yields both placements.
+//
+// Rows above the stack are skipped: while a piece is entirely in empty rows,
+// moves and rotations never change its row (no SRS kick is taken in free air),
+// so every pose reachable higher up is reachable from the same rotation and
+// column just above the stack.
+void MoveGenerator::generate(const GameMatrix &matrix, const Tetrimino &piece, vector<Placement> &placements) {
+    placements.clear();
+    _visited.reset();
+    for (auto &placed : _placed) placed.reset();
+    _queueSize = 0;
+
+    _type = piece.getType();
+    _tracksSpin = piece.canTSpin();
+    buildFitTable(matrix);
+
+    const Vector2i position = piece.getPosition();
+    Pose start{piece.getRotation(), position.row, position.column};
+    if (!fits(start.rotation, start.row, start.column)) return;
+
+    const int deepRow = stackTop(matrix) - 3; // lowest row where every facing is still in free rows
+    if (start.row < deepRow) start.row = deepRow;
+
+    arrive(matrix, start, 0, placements);
+
+    for (size_t head = 0; head < _queueSize; head++) {
+        const Pose current = _queue[head];
+
+        for (const int step : {-1, 1}) {
+            if (fits(current.rotation, current.row, current.column + step))
+                arrive(matrix, {current.rotation, current.row, current.column + step}, 0, placements);
+        }
+        if (fits(current.rotation, current.row + 1, current.column))
+            arrive(matrix, {current.rotation, current.row + 1, current.column}, 0, placements);
+
+        for (const Direction direction : {Direction::Left, Direction::Right}) {
+            Pose next{};
+            if (const int point = rotate(current, direction, next); point > 0) arrive(matrix, next, point, placements);
+        }
+    }
+}
+
+vector<Placement> MoveGenerator::generate(const GameState &state) {
+    vector<Placement> placements;
+    if (state.pieces.current) generate(state.matrix, *state.pieces.current, placements);
+    return placements;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include "GameMatrix.h"
+#include "PieceData.h"
+#include "Tetrimino.h"
+
+class GameState;
+
+enum class SpinType : uint8_t { None, Mini, Full };
+
+// A final resting pose: the piece as it would lock (row, column, rotation and
+// the kick that brought it there) and the T-spin it would score.
+struct Placement {
+    Tetrimino piece;
+    SpinType spin{SpinType::None};
+};
+
+// Enumerates every distinct resting placement reachable from a piece through
+// left, right, soft drop and both rotations, trying the same SRS kicks in the
+// same order as Tetrimino::rotate. Placements that fill the same cells (O, I, S
+// and Z rotations) are reported once; a T pose reachable both with and without
+// a spin is reported once per spin type.
+//
+// The generator owns its search buffers, so keep one per thread and reuse it:
+// generate() does not allocate once the output vector has grown.
+class MoveGenerator {
+public:
+    void generate(const GameMatrix &matrix, const Tetrimino &piece, std::vector<Placement> &placements);
+    // Placements of the current piece; empty when there is none.
+    [[nodiscard]] std::vector<Placement> generate(const GameState &state);
+
+private:
+    static constexpr int kRows = BOARD_HEIGHT + 2;    // piece rows -1..BOARD_HEIGHT
+    static constexpr int kColumns = BOARD_WIDTH + 6; // piece columns -2..BOARD_WIDTH+3
+    static constexpr size_t kPoseCount = static_cast<size_t>(ROTATION_COUNT * kRows * kColumns);
+
+    struct Pose {
+        Rotation rotation;
+        int row;
+        int column;
+    };
+
+    [[nodiscard]] static size_t poseIndex(Rotation rotation, int row, int column);
+    [[nodiscard]] static size_t poseIndex(const Pose &pose) { return poseIndex(pose.rotation, pose.row, pose.column); }
+
+    void buildFitTable(const GameMatrix &matrix);
+    [[nodiscard]] bool fits(Rotation rotation, int row, int column) const;
+    [[nodiscard]] bool isResting(const Pose &pose) const { return !fits(pose.rotation, pose.row + 1, pose.column); }
+    // Kick point (1-based, as Tetrimino tracks it) of a successful rotation, 0 if it fails.
+    [[nodiscard]] int rotate(const Pose &pose, Direction direction, Pose &result) const;
+
+    void arrive(const GameMatrix &matrix, const Pose &pose, int rotationPoint, std::vector<Placement> &placements);
+    void addPlacement(const Tetrimino &piece, SpinType spin, std::vector<Placement> &placements);
+
+    PieceType _type{};
+    bool _tracksSpin{};
+
+    // _fitRows[rotation][column + 2] has bit (row + 1) set when the piece fits
+    // there, so every collision test of the search is one bit test.
+    std::array<std::array<uint64_t, kColumns>, ROTATION_COUNT> _fitRows{};
+
+    std::bitset<kPoseCount> _visited;
+    std::array<std::bitset<kPoseCount>, 3> _placed; // one per SpinType
+    std::array<Pose, kPoseCount> _queue{};
+    size_t _queueSize{};
+};
@@ -1,29 +1,21 @@
 #include "PieceMovement.h"
 
-#include "GravityPolicy.h"
+#include "GameTimers.h"
 #include "LockDownPolicy.h"
-#include "Timer.h"
+#include "TickTimings.h"
 
 using namespace std;
 
-static constexpr auto kFall = "fall";
-static constexpr auto kAutorepeatLeft = "autorepeatleft";
-static constexpr auto kAutorepeatRight = "autorepeatright";
-static constexpr auto kLockDown = "lockdown";
-static constexpr auto kGeneration = "generation";
-static constexpr auto kHardDropTrail = "harddroptrail";
-static constexpr double kAutorepeatDelay = 0.25;
-static constexpr double kAutorepeatSpeed = 0.01;
-static constexpr double kLockDownDelay = 0.5;
-static constexpr double kGenerationDelay = 0.2;
 static constexpr int kSoftDropScore = 1;
 static constexpr int kHardDropScore = 2;
 
-PieceMovement::PieceMovement(Timer &timer, LockDownPolicy *lockDown, GravityPolicy *gravity)
-    : _timer(timer), _lockDown(lockDown), _gravity(gravity) {
+template <class LockDown>
+BasicPieceMovement<LockDown>::BasicPieceMovement(GameTimers &timers, const TickTimings &timings, LockDown *lockDown)
+    : _timer(timers), _timings(timings), _lockDown(lockDown) {
 }
 
-void PieceMovement::stepFalling(GameState &state, const InputSnapshot &input) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::stepFalling(GameState &state, const InputSnapshot &input) {
     switch (state.flags.stepState) {
         case GameStep::Idle: stepIdle(state, input); break;
         case GameStep::MoveLeft: stepMoveLeft(state, input); break;
@@ -43,16 +35,68 @@ void PieceMovement::stepFalling(GameState &state, const InputSnapshot &input) {
     }
 }
 
-void PieceMovement::resetTimers() const {
-    _timer.stopTimer(kFall);
-    _timer.stopTimer(kAutorepeatLeft);
-    _timer.stopTimer(kAutorepeatRight);
-    _timer.stopTimer(kLockDown);
-    _timer.stopTimer(kHardDropTrail);
+template <class LockDown>
+void BasicPieceMovement<LockDown>::resetTimers() const {
+    _timer.stopTimer(GameTimer::Fall);
+    _timer.stopTimer(GameTimer::AutorepeatLeft);
+    _timer.stopTimer(GameTimer::AutorepeatRight);
+    _timer.stopTimer(GameTimer::LockDown);
+    _timer.stopTimer(GameTimer::HardDropTrail);
 }
 
-void PieceMovement::fall(GameState &state, const InputSnapshot &input) const {
-    if (state.pieces.current == nullptr) return;
+// The next row of gravity, the end of the lock delay or the next autorepeat
+// move, whichever comes first. Inputs that retry every step (a rotation that
+// did not fit, a hard drop or hold still held) and releases that still have a
+// timer to stop need the very next tick.
+template <class LockDown>
+int64_t BasicPieceMovement<LockDown>::nextDeadline(const GameState &state, const InputSnapshot &input) const {
+    const int64_t next = _timer.now() + 1;
+    if (!state.pieces.current || state.flags.stepState == GameStep::HardDrop) return next;
+
+    const bool rotating = input.rotateCW || input.rotateCCW;
+    const int dropDistance = state.dropDistance();
+    if (input.hardDrop || rotating != state.flags.didRotate) return next;
+    if (input.softDrop && state.config.sonicDrop && dropDistance > 0) return next;
+    if (input.hold && state.config.holdEnabled && !state.pieces.isNewHold) return next;
+    if (input.left != _timer.exist(GameTimer::AutorepeatLeft)) return next;
+    if (input.right != _timer.exist(GameTimer::AutorepeatRight)) return next;
+    if (const int limit = _lockDown->moveLimit(); limit >= 0 && state.lockDown.moveCount >= limit) return next;
+    if (dropDistance == 0 && !_timer.exist(GameTimer::LockDown)) return next;
+
+    int64_t deadline = _timer.deadline(GameTimer::LockDown, _timings.level(state.stats.level).lockDelay);
+
+    switch (state.flags.stepState) {
+        case GameStep::Idle:
+            if (input.left)
+                deadline = min(deadline, _timer.deadline(GameTimer::AutorepeatLeft, _timings.autorepeatDelay));
+            if (input.right)
+                deadline = min(deadline, _timer.deadline(GameTimer::AutorepeatRight, _timings.autorepeatDelay));
+            break;
+        case GameStep::MoveLeft:
+            deadline = min(deadline, _timer.deadline(GameTimer::AutorepeatLeft, _timings.autorepeatInterval));
+            break;
+        case GameStep::MoveRight:
+            deadline = min(deadline, _timer.deadline(GameTimer::AutorepeatRight, _timings.autorepeatInterval));
+            break;
+        case GameStep::HardDrop: break;
+    }
+
+    // applyGravity() drops a row once the progress reaches kGravityOne; a piece
+    // resting on the stack still resets its progress there.
+    const LevelTimings &level = _timings.level(state.stats.level);
+    const int64_t gravity = input.softDrop ? level.softGravity : level.gravity;
+    if (gravity >= kGravityOne) {
+        if (dropDistance > 0) return next;
+    } else if (gravity > 0) {
+        const int64_t ticks = (kGravityOne - state.pieces.fallProgress + gravity - 1) / gravity;
+        deadline = min(deadline, _timer.deadline(GameTimer::Fall, max<int64_t>(ticks, 1)));
+    }
+    return max(deadline, next);
+}
+
+template <class LockDown>
+void BasicPieceMovement<LockDown>::fall(GameState &state, const InputSnapshot &input) const {
+    if (!state.pieces.current) return;
 
     if (input.hardDrop && state.flags.stepState != GameStep::HardDrop) {
         state.queueSound(GameSound::HardDrop);
@@ -67,9 +111,7 @@ void PieceMovement::fall(GameState &state, const InputSnapshot &input) const {
                       || state.pieces.current->isMino(startRow + 2, i)
                       || state.pieces.current->isMino(startRow + 3, i);
 
-        while (moveDown(state)) {
-            state.stats.score += kHardDropScore;
-        }
+        state.stats.score += kHardDropScore * dropToBottom(state);
 
         const int endRow = state.pieces.current->getPosition().row;
         if (endRow > startRow) {
@@ -81,7 +123,7 @@ void PieceMovement::fall(GameState &state, const InputSnapshot &input) const {
             trail.active = true;
             for (int i = 0; i < BOARD_WIDTH; i++)
                 trail.columns[i] = columns[i];
-            _timer.resetTimer(kHardDropTrail);
+            _timer.resetTimer(GameTimer::HardDropTrail);
         }
 
         lock(state);
@@ -90,30 +132,33 @@ void PieceMovement::fall(GameState &state, const InputSnapshot &input) const {
 
     const DropType dropType = input.softDrop ? DropType::Soft : DropType::Normal;
 
-    if (const double interval = _gravity->fallInterval(state.stats.level, dropType);
-        _timer.getSeconds(kFall) >= interval) {
-        _timer.resetTimer(kFall);
-        if (moveDown(state)) {
-            if (dropType == DropType::Soft)
-                state.stats.score += kSoftDropScore;
-
-            if (state.lockDown.active) {
-                if (const int currentLine = state.pieces.current->getPosition().row;
-                    currentLine > state.lockDown.lowestLine) {
-                    state.lockDown.lowestLine = currentLine;
-                    state.lockDown.moveCount = 0;
-                    _timer.resetTimer(kLockDown);
-                }
+    int dropped = 0;
+    if (dropType == DropType::Soft && state.config.sonicDrop) {
+        dropped = dropToBottom(state);
+    } else {
+        dropped = applyGravity(state, dropType);
+    }
+
+    if (dropped > 0) {
+        if (dropType == DropType::Soft)
+            state.stats.score += kSoftDropScore * dropped;
+
+        if (state.lockDown.active) {
+            if (const int currentLine = state.pieces.current->getPosition().row;
+                currentLine > state.lockDown.lowestLine) {
+                state.lockDown.lowestLine = currentLine;
+                state.lockDown.moveCount = 0;
+                _timer.resetTimer(GameTimer::LockDown);
             }
         }
     }
 
-    if (!state.pieces.current->simulateMove(Vector2i(1, 0)) && !_timer.exist(kLockDown)) {
-        _timer.startTimer(kLockDown);
+    if (state.dropDistance() == 0 && !_timer.exist(GameTimer::LockDown)) {
+        _timer.startTimer(GameTimer::LockDown);
         state.lockDown.active = true;
     }
 
-    if (_timer.getSeconds(kLockDown) >= kLockDownDelay) {
+    if (_timer.getTicks(GameTimer::LockDown) >= _timings.level(state.stats.level).lockDelay) {
         lock(state);
         if (state.flags.isGameOver) return;
     }
@@ -123,35 +168,58 @@ void PieceMovement::fall(GameState &state, const InputSnapshot &input) const {
     }
 }
 
-void PieceMovement::stepIdle(GameState &state, const InputSnapshot &input) {
+// Adds the gravity of the ticks since the last step to the piece's fall
+// progress and drops every whole row of it at once, so fast levels fall at
+// the rate of the curve rather than one row per step. Below one cell per tick
+// the remainder is dropped after each row, keeping rows exactly a table
+// interval apart. Rows the stack blocks are not owed later.
+template <class LockDown>
+int BasicPieceMovement<LockDown>::applyGravity(GameState &state, const DropType dropType) const {
+    const LevelTimings &level = _timings.level(state.stats.level);
+    const int64_t gravity = dropType == DropType::Soft ? level.softGravity : level.gravity;
+    int64_t &progress = state.pieces.fallProgress;
+
+    progress += _timer.getTicks(GameTimer::Fall) * gravity;
+    _timer.resetTimer(GameTimer::Fall);
+    if (progress < kGravityOne) return 0;
+
+    const int64_t owed = progress / kGravityOne;
+    const int dropped = moveDown(state, static_cast<int>(min<int64_t>(owed, state.dropDistance())));
+    progress = gravity < kGravityOne || dropped < owed ? 0 : progress - dropped * kGravityOne;
+    return dropped;
+}
+
+template <class LockDown>
+void BasicPieceMovement<LockDown>::stepIdle(GameState &state, const InputSnapshot &input) {
     fall(state, input);
     if (state.flags.isGameOver) return;
 
-    checkAutorepeat(state, input.left, kAutorepeatLeft, &PieceMovement::moveLeft, GameStep::MoveLeft);
-    checkAutorepeat(state, input.right, kAutorepeatRight, &PieceMovement::moveRight, GameStep::MoveRight);
+    checkAutorepeat(state, input.left, GameTimer::AutorepeatLeft, &BasicPieceMovement::moveLeft, GameStep::MoveLeft);
+    checkAutorepeat(state, input.right, GameTimer::AutorepeatRight, &BasicPieceMovement::moveRight,
+                    GameStep::MoveRight);
 
     if (state.config.holdEnabled && !state.pieces.isNewHold && input.hold) {
-        Tetrimino *buffer = state.pieces.hold;
-        state.pieces.hold = state.pieces.current;
-        state.pieces.current = buffer;
-        if (state.pieces.current != nullptr) {
+        std::swap(state.pieces.hold, state.pieces.current);
+        if (state.pieces.current) {
             state.pieces.current->resetRotation();
-            if (!state.pieces.current->setPosition(state.pieces.current->getStartingPosition())) {
+            if (!state.pieces.current->setPosition(state.matrix, state.pieces.current->getStartingPosition())) {
                 state.flags.isGameOver = true;
                 return;
             }
-            _timer.startTimer(kFall);
+            _timer.startTimer(GameTimer::Fall);
+            state.pieces.fallProgress = 0;
             state.markDirty();
         } else {
             state.phase = GamePhase::Generation;
-            _timer.resetTimer(kGeneration, kGenerationDelay);
+            _timer.resetTimer(GameTimer::Generation, _timings.generationDelay);
         }
         state.pieces.isNewHold = true;
     }
 }
 
-void PieceMovement::stepMoveLeft(GameState &state, const InputSnapshot &input) const {
-    if (state.pieces.current == nullptr) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::stepMoveLeft(GameState &state, const InputSnapshot &input) const {
+    if (!state.pieces.current) {
         state.flags.stepState = GameStep::Idle;
         return;
     }
@@ -161,17 +229,18 @@ void PieceMovement::stepMoveLeft(GameState &state, const InputSnapshot &input) c
 
     if (!input.left) {
         state.flags.stepState = GameStep::Idle;
-        _timer.stopTimer(kAutorepeatLeft);
+        _timer.stopTimer(GameTimer::AutorepeatLeft);
     }
 
-    if (_timer.getSeconds(kAutorepeatLeft) >= kAutorepeatSpeed) {
+    if (_timer.getTicks(GameTimer::AutorepeatLeft) >= _timings.autorepeatInterval) {
         moveLeft(state);
-        _timer.resetTimer(kAutorepeatLeft);
+        _timer.resetTimer(GameTimer::AutorepeatLeft);
     }
 }
 
-void PieceMovement::stepMoveRight(GameState &state, const InputSnapshot &input) const {
-    if (state.pieces.current == nullptr) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::stepMoveRight(GameState &state, const InputSnapshot &input) const {
+    if (!state.pieces.current) {
         state.flags.stepState = GameStep::Idle;
         return;
     }
@@ -181,46 +250,48 @@ void PieceMovement::stepMoveRight(GameState &state, const InputSnapshot &input)
 
     if (!input.right) {
         state.flags.stepState = GameStep::Idle;
-        _timer.stopTimer(kAutorepeatRight);
+        _timer.stopTimer(GameTimer::AutorepeatRight);
     }
 
-    if (_timer.getSeconds(kAutorepeatRight) >= kAutorepeatSpeed) {
+    if (_timer.getTicks(GameTimer::AutorepeatRight) >= _timings.autorepeatInterval) {
         moveRight(state);
-        _timer.resetTimer(kAutorepeatRight);
+        _timer.resetTimer(GameTimer::AutorepeatRight);
     }
 }
 
-void PieceMovement::stepHardDrop(GameState &state) const {
-    if (state.pieces.current == nullptr) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::stepHardDrop(GameState &state) const {
+    if (!state.pieces.current) {
         state.flags.stepState = GameStep::Idle;
         return;
     }
 
-    while (moveDown(state)) {
-        state.stats.score += 2;
-    }
+    state.stats.score += kHardDropScore * dropToBottom(state);
     lock(state);
 }
 
-void PieceMovement::incrementMove(GameState &state) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::incrementMove(GameState &state) {
     state.queueSound(GameSound::Click);
     if (state.lockDown.active) state.lockDown.moveCount++;
 }
 
-void PieceMovement::resetLockDown(const GameState &state) const {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::resetLockDown(const GameState &state) const {
     if (!_lockDown->resetsTimerOnMove()) return;
 
     if (state.lockDown.active) {
-        _timer.resetTimer(kLockDown);
+        _timer.resetTimer(GameTimer::LockDown);
     }
 }
 
-void PieceMovement::moveLeft(GameState &state) const {
-    if (state.pieces.current == nullptr) return;
+template <class LockDown>
+void BasicPieceMovement<LockDown>::moveLeft(GameState &state) const {
+    if (!state.pieces.current) return;
 
     if (state.flags.stepState == GameStep::HardDrop) return;
 
-    if (state.pieces.current->move(Vector2i(0, -1))) {
+    if (state.pieces.current->move(state.matrix, Vector2i(0, -1))) {
         state.flags.lastMoveIsTSpin = false;
         state.flags.lastMoveIsMiniTSpin = false;
         incrementMove(state);
@@ -229,10 +300,11 @@ void PieceMovement::moveLeft(GameState &state) const {
     }
 }
 
-void PieceMovement::moveRight(GameState &state) const {
-    if (state.pieces.current == nullptr) return;
+template <class LockDown>
+void BasicPieceMovement<LockDown>::moveRight(GameState &state) const {
+    if (!state.pieces.current) return;
 
-    if (state.pieces.current->move(Vector2i(0, 1))) {
+    if (state.pieces.current->move(state.matrix, Vector2i(0, 1))) {
         state.flags.lastMoveIsTSpin = false;
         state.flags.lastMoveIsMiniTSpin = false;
         incrementMove(state);
@@ -241,21 +313,29 @@ void PieceMovement::moveRight(GameState &state) const {
     }
 }
 
-bool PieceMovement::moveDown(GameState &state) {
-    if (state.pieces.current->move(Vector2i(1, 0))) {
-        state.flags.lastMoveIsTSpin = false;
-        state.flags.lastMoveIsMiniTSpin = false;
-        state.markDirty();
-        return true;
-    }
+// Moves the piece down `rows` rows in one step; the caller keeps `rows` within
+// the drop distance. Returns the rows fallen.
+template <class LockDown>
+int BasicPieceMovement<LockDown>::moveDown(GameState &state, const int rows) {
+    if (rows <= 0 || !state.pieces.current->move(state.matrix, Vector2i(rows, 0))) return 0;
 
-    return false;
+    state.flags.lastMoveIsTSpin = false;
+    state.flags.lastMoveIsMiniTSpin = false;
+    state.markDirty();
+    return rows;
 }
 
-void PieceMovement::rotate(GameState &state, const Direction direction) const {
-    if (state.pieces.current == nullptr) return;
+// Moves the piece straight onto the stack in one step; returns the rows fallen.
+template <class LockDown>
+int BasicPieceMovement<LockDown>::dropToBottom(GameState &state) {
+    return moveDown(state, state.dropDistance());
+}
 
-    if (state.pieces.current->rotate(direction)) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::rotate(GameState &state, const Direction direction) const {
+    if (!state.pieces.current) return;
+
+    if (state.pieces.current->rotate(state.matrix, direction)) {
         state.flags.didRotate = true;
         state.flags.lastMoveIsTSpin = false;
         state.flags.lastMoveIsMiniTSpin = false;
@@ -264,20 +344,21 @@ void PieceMovement::rotate(GameState &state, const Direction direction) const {
         state.markDirty();
 
         if (state.pieces.current->canTSpin()) {
-            if (state.pieces.current->checkTSpin())
+            if (state.pieces.current->checkTSpin(state.matrix))
                 state.flags.lastMoveIsTSpin = true;
-            else if (state.pieces.current->checkMiniTSpin())
+            else if (state.pieces.current->checkMiniTSpin(state.matrix))
                 state.flags.lastMoveIsMiniTSpin = true;
         }
     }
 }
 
-void PieceMovement::lock(GameState &state) const {
-    if (state.pieces.current == nullptr || state.flags.isGameOver) return;
+template <class LockDown>
+void BasicPieceMovement<LockDown>::lock(GameState &state) const {
+    if (!state.pieces.current || state.flags.isGameOver) return;
 
     // False alarm: the piece was nudged off its resting surface (e.g. slid over a gap)
-    if (state.pieces.current->simulateMove(Vector2i(1, 0))) {
-        _timer.stopTimer(kLockDown);
+    if (state.dropDistance() > 0) {
+        _timer.stopTimer(GameTimer::LockDown);
         state.lockDown.moveCount = 0;
         if (const int row = state.pieces.current->getPosition().row; row > state.lockDown.lowestLine)
             state.lockDown.lowestLine = row;
@@ -285,7 +366,7 @@ void PieceMovement::lock(GameState &state) const {
     }
 
     // Lock-out: the piece overlaps the buffer zone
-    if (!state.pieces.current->lock()) {
+    if (!state.pieces.current->lock(state.matrix)) {
         state.flags.isGameOver = true;
         return;
     }
@@ -296,25 +377,26 @@ void PieceMovement::lock(GameState &state) const {
     state.lockDown.active = false;
     state.lockDown.moveCount = 0;
     state.lockDown.lowestLine = 0;
-    state.pieces.current = nullptr;
+    state.pieces.current.reset();
     state.stats.nbMinos++;
 
-    _timer.stopTimer(kLockDown);
+    _timer.stopTimer(GameTimer::LockDown);
 
     state.phase = GamePhase::Pattern;
     state.flags.stepState = GameStep::Idle;
     state.markDirty();
 }
 
-void PieceMovement::checkAutorepeat(GameState &state, const bool input, const string &timer, const MoveFunc move,
-                                    const GameStep nextState) {
+template <class LockDown>
+void BasicPieceMovement<LockDown>::checkAutorepeat(GameState &state, const bool input, const GameTimer timer,
+                                                   const MoveFunc move, const GameStep nextState) {
     if (input) {
         if (!_timer.exist(timer)) {
             (this->*move)(state);
             _timer.startTimer(timer);
         }
 
-        if (_timer.getSeconds(timer) >= kAutorepeatDelay) {
+        if (_timer.getTicks(timer) >= _timings.autorepeatDelay) {
             _timer.startTimer(timer);
             (this->*move)(state);
             state.flags.stepState = nextState;
@@ -323,3 +405,6 @@ void PieceMovement::checkAutorepeat(GameState &state, const bool input, const st
         _timer.stopTimer(timer);
     }
 }
+
+template class BasicPieceMovement<LockDownPolicy>;
+template class BasicPieceMovement<ExtendedLockDown>;
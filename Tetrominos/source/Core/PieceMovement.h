@@ -1,25 +1,32 @@
 #pragma once
 
-#include <string>
-
-#include "Facing.h"
+#include "PieceData.h"
 #include "GameState.h"
 #include "InputSnapshot.h"
 
-class GravityPolicy;
+class GameTimers;
+enum class GameTimer : uint8_t;
 class LockDownPolicy;
-class Timer;
+struct TickTimings;
 
-class PieceMovement {
+// Falling-phase rules. LockDown is LockDownPolicy for the runtime-configurable
+// game, or a final policy class for fixed rule sets (see BasicGameController).
+// The member definitions live in PieceMovement.cpp, instantiated for both.
+template <class LockDown>
+class BasicPieceMovement {
 public:
-    PieceMovement(Timer &timer, LockDownPolicy *lockDown, GravityPolicy *gravity);
+    BasicPieceMovement(GameTimers &timers, const TickTimings &timings, LockDown *lockDown);
 
     void stepFalling(GameState &state, const InputSnapshot &input);
     void resetTimers() const;
-    void setLockDownPolicy(LockDownPolicy *p) { _lockDown = p; }
+    // The first tick after the last step at which stepFalling() with the same
+    // `input` changes the state; any other input needs a step of its own.
+    [[nodiscard]] int64_t nextDeadline(const GameState &state, const InputSnapshot &input) const;
+    void setLockDownPolicy(LockDown *p) { _lockDown = p; }
 
 private:
     void fall(GameState &state, const InputSnapshot &input) const;
+    int applyGravity(GameState &state, DropType dropType) const;
     void stepIdle(GameState &state, const InputSnapshot &input);
     void stepMoveLeft(GameState &state, const InputSnapshot &input) const;
     void stepMoveRight(GameState &state, const InputSnapshot &input) const;
@@ -29,14 +36,17 @@ private:
     void resetLockDown(const GameState &state) const;
     void moveLeft(GameState &state) const;
     void moveRight(GameState &state) const;
-    [[nodiscard]] static bool moveDown(GameState &state);
+    static int moveDown(GameState &state, int rows);
+    static int dropToBottom(GameState &state);
     void rotate(GameState &state, Direction direction) const;
     void lock(GameState &state) const;
 
-    using MoveFunc = void (PieceMovement::*)(GameState &) const;
-    void checkAutorepeat(GameState &state, bool input, const std::string &timer, MoveFunc move, GameStep nextState);
+    using MoveFunc = void (BasicPieceMovement::*)(GameState &) const;
+    void checkAutorepeat(GameState &state, bool input, GameTimer timer, MoveFunc move, GameStep nextState);
 
-    Timer &_timer;
-    LockDownPolicy *_lockDown;
-    GravityPolicy *_gravity;
+    GameTimers &_timer;
+    const TickTimings &_timings;
+    LockDown *_lockDown;
 };
+
+using PieceMovement = BasicPieceMovement<LockDownPolicy>;
@@ -0,0 +1,73 @@
+#include "PieceQueue.h"
+
+#include <cassert>
+#include <utility>
+
+#include "Zobrist.h"
+
+using namespace std;
+
+PieceQueue::PieceQueue() = default;
+
+PieceQueue::~PieceQueue() = default;
+
+void PieceQueue::reset(unique_ptr<Randomizer> randomizer, Rng &rng) {
+    _randomizer = std::move(randomizer);
+    _head = 0;
+    for (auto &piece : _ring)
+        piece = _randomizer->next(rng);
+    rehash();
+}
+
+PieceType PieceQueue::pop(Rng &rng) {
+    assert(_randomizer);
+    const PieceType piece = _ring[_head];
+    _ring[_head] = _randomizer->next(rng);
+    _head = wrap(_head + 1);
+
+    // Position i's key is rotated left by i: drop the front piece, move every
+    // other one a position forward with one rotation, then add the new last one.
+    _hash = rotateLeft(_hash ^ zobristQueue(0, piece), 63);
+    _hash ^= zobristQueue(kHashedPieces - 1, peek(kHashedPieces - 1));
+    return piece;
+}
+
+PieceType PieceQueue::peek(const size_t n) const {
+    assert(n < kCapacity);
+    return _ring[wrap(_head + n)];
+}
+
+PieceQueue::Snapshot PieceQueue::snapshot() const {
+    assert(_randomizer);
+    return {_ring, _head, _randomizer->save()};
+}
+
+void PieceQueue::restore(const Snapshot &snapshot) {
+    assert(_randomizer);
+    _ring = snapshot.ring;
+    _head = snapshot.head;
+    _randomizer->restore(snapshot.randomizer);
+    rehash();
+}
+
+void PieceQueue::replace(const size_t n, const PieceType type) {
+    assert(n < kCapacity);
+    PieceType &piece = _ring[wrap(_head + n)];
+    if (n < kHashedPieces) _hash ^= zobristQueue(n, piece) ^ zobristQueue(n, type);
+    piece = type;
+}
+
+void PieceQueue::rehash() {
+    _hash = 0;
+    for (size_t i = 0; i < kHashedPieces; i++) _hash ^= zobristQueue(i, peek(i));
+}
+
+void PieceQueue::moveToFront(const PieceType type) {
+    for (size_t i = 0; i < kCapacity; i++) {
+        if (auto &piece = _ring[wrap(_head + i)]; piece == type) {
+            swap(piece, _ring[_head]);
+            rehash();
+            return;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "PieceData.h"
+#include "Randomizer.h"
+
+// Upcoming pieces as a fixed ring buffer of PieceType. The ring is always kept
+// full from the randomizer, so peek(n) is a single indexed read for any n below
+// kCapacity, and popping refills one slot. Nothing is allocated after reset().
+// hash() covers the first kHashedPieces pieces and is updated in O(1) per pop.
+class PieceQueue {
+public:
+    static constexpr size_t kCapacity = 64; // power of two; also the maximum lookahead
+    static constexpr size_t kHashedPieces = 6; // the longest preview
+
+    // The ring and the randomizer state; restore() needs the same randomizer type.
+    struct Snapshot {
+        std::array<PieceType, kCapacity> ring{};
+        size_t head{};
+        RandomizerState randomizer;
+    };
+
+    PieceQueue();
+    ~PieceQueue();
+
+    void reset(std::unique_ptr<Randomizer> randomizer, Rng &rng);
+    [[nodiscard]] PieceType pop(Rng &rng);
+    [[nodiscard]] PieceType peek(size_t n) const;
+    [[nodiscard]] static constexpr size_t capacity() { return kCapacity; }
+    [[nodiscard]] uint64_t hash() const { return _hash; }
+
+    [[nodiscard]] Snapshot snapshot() const;
+    void restore(const Snapshot &snapshot);
+
+    // Overwrites the piece `n` places from the front; the randomizer is not touched.
+    void replace(size_t n, PieceType type);
+
+    // Swap the first queued piece of this type to the front (debug scenarios).
+    void moveToFront(PieceType type);
+
+private:
+    static_assert((kCapacity & (kCapacity - 1)) == 0);
+
+    [[nodiscard]] static size_t wrap(const size_t index) { return index & (kCapacity - 1); }
+    void rehash();
+
+    std::unique_ptr<Randomizer> _randomizer;
+    std::array<PieceType, kCapacity> _ring{};
+    size_t _head{};
+    uint64_t _hash{};
+};
@@ -0,0 +1,212 @@
+#include "Replay.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+static constexpr uint32_t kReplayMagic = 0x50524354; // "TCRP" little-endian
+static constexpr uint32_t kReplayVersion = 3; // 2 adds sonicDrop, 3 records ticks instead of ms
+static constexpr int kLegacyTickRate = 1000; // versions 1-2 recorded whole milliseconds
+
+uint8_t packInput(const InputSnapshot &input) {
+    uint8_t bits = 0;
+    if (input.left) bits |= 1u << 0;
+    if (input.right) bits |= 1u << 1;
+    if (input.softDrop) bits |= 1u << 2;
+    if (input.hardDrop) bits |= 1u << 3;
+    if (input.rotateCW) bits |= 1u << 4;
+    if (input.rotateCCW) bits |= 1u << 5;
+    if (input.hold) bits |= 1u << 6;
+    if (input.pause) bits |= 1u << 7;
+    return bits;
+}
+
+InputSnapshot unpackInput(const uint8_t bits) {
+    InputSnapshot input;
+    input.left = (bits & (1u << 0)) != 0;
+    input.right = (bits & (1u << 1)) != 0;
+    input.softDrop = (bits & (1u << 2)) != 0;
+    input.hardDrop = (bits & (1u << 3)) != 0;
+    input.rotateCW = (bits & (1u << 4)) != 0;
+    input.rotateCCW = (bits & (1u << 5)) != 0;
+    input.hold = (bits & (1u << 6)) != 0;
+    input.pause = (bits & (1u << 7)) != 0;
+    return input;
+}
+
+// LEB128 varint: 7 bits per byte, high bit set on all but the last byte
+static void writeVarint(ostream &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+static bool readVarint(istream &in, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int byte = in.get();
+        if (byte == EOF) return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+template <typename T>
+static void writeRaw(ostream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool readRaw(istream &in, T &value) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+bool saveReplay(const Replay &replay, const string &path) {
+    ostringstream buf;
+    writeRaw(buf, kReplayMagic);
+    writeRaw(buf, kReplayVersion);
+    writeRaw(buf, replay.seed);
+    writeRaw(buf, static_cast<int32_t>(replay.tickRate));
+    writeRaw(buf, replay.startTick);
+
+    const auto &c = replay.config;
+    writeRaw(buf, static_cast<int32_t>(c.variant));
+    writeRaw(buf, static_cast<int32_t>(c.mode));
+    writeRaw(buf, static_cast<int32_t>(c.randomizer));
+    writeRaw(buf, static_cast<int32_t>(c.startingLevel));
+    writeRaw(buf, static_cast<int32_t>(c.previewCount));
+    writeRaw(buf, static_cast<uint8_t>(c.ghostEnabled));
+    writeRaw(buf, static_cast<uint8_t>(c.holdEnabled));
+    writeRaw(buf, static_cast<uint8_t>(c.sonicDrop));
+
+    writeVarint(buf, replay.runs.size());
+    for (const auto &run : replay.runs) {
+        buf.put(static_cast<char>(run.input));
+        writeVarint(buf, run.deltaTicks);
+        writeVarint(buf, run.count);
+    }
+
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) return false;
+    const string data = buf.str();
+    out.write(data.data(), static_cast<streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+bool loadReplay(Replay &replay, const string &path) {
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t magic = 0, version = 0;
+    if (!readRaw(in, magic) || !readRaw(in, version)) return false;
+    if (magic != kReplayMagic || version < 1 || version > kReplayVersion) return false;
+
+    Replay result;
+    int32_t tickRate = kLegacyTickRate;
+    if (!readRaw(in, result.seed)) return false;
+    if (version >= 3 && !readRaw(in, tickRate)) return false;
+    if (!readRaw(in, result.startTick) || tickRate < MIN_TICK_RATE || tickRate > MAX_TICK_RATE) return false;
+    result.tickRate = tickRate;
+
+    int32_t variant = 0, mode = 0, randomizer = 0, startingLevel = 0, previewCount = 0;
+    uint8_t ghost = 0, hold = 0, sonic = 0;
+    if (!readRaw(in, variant) || !readRaw(in, mode) || !readRaw(in, randomizer) || !readRaw(in, startingLevel) ||
+        !readRaw(in, previewCount) || !readRaw(in, ghost) || !readRaw(in, hold))
+        return false;
+    if (version >= 2 && !readRaw(in, sonic)) return false;
+    // The same ranges GameState::loadOptions() clamps to; anything else would index past the tables
+    if (variant < 0 || static_cast<size_t>(variant) >= VARIANT_COUNT) return false;
+    if (mode < 0 || mode > static_cast<int32_t>(LockDownMode::Classic)) return false;
+    if (randomizer < 0 || randomizer > static_cast<int32_t>(RandomizerType::TgmHistory)) return false;
+    if (startingLevel < MIN_LEVEL || startingLevel > MAX_MASTER_LEVEL || previewCount < 0 || previewCount > 6)
+        return false;
+
+    result.config.variant = static_cast<GameVariant>(variant);
+    result.config.mode = static_cast<LockDownMode>(mode);
+    result.config.randomizer = static_cast<RandomizerType>(randomizer);
+    result.config.startingLevel = startingLevel;
+    result.config.previewCount = previewCount;
+    result.config.ghostEnabled = ghost != 0;
+    result.config.holdEnabled = hold != 0;
+    result.config.sonicDrop = sonic != 0;
+    result.config.seed = result.seed;
+
+    uint64_t runCount = 0;
+    if (!readVarint(in, runCount)) return false;
+    for (uint64_t i = 0; i < runCount; i++) {
+        const int input = in.get();
+        uint64_t deltaTicks = 0, count = 0;
+        if (input == EOF || !readVarint(in, deltaTicks) || !readVarint(in, count)) return false;
+        result.runs.push_back(
+            {static_cast<uint8_t>(input), static_cast<uint32_t>(deltaTicks), static_cast<uint32_t>(count)});
+    }
+
+    replay = std::move(result);
+    return true;
+}
+
+void ReplayRecorder::begin(const uint64_t seed, const GameConfig &config, const int tickRate, const int64_t startTick) {
+    _replay = {};
+    _replay.seed = seed;
+    _replay.config = config;
+    _replay.tickRate = tickRate;
+    _replay.startTick = startTick;
+    _lastTick = startTick;
+    _active = true;
+}
+
+void ReplayRecorder::record(const InputSnapshot &input, const int64_t tick) {
+    if (!_active) return;
+
+    const uint8_t bits = packInput(input);
+    const auto deltaTicks = static_cast<uint32_t>(tick - _lastTick);
+    _lastTick = tick;
+
+    if (!_replay.runs.empty()) {
+        if (auto &last = _replay.runs.back(); last.input == bits && last.deltaTicks == deltaTicks) {
+            last.count++;
+            return;
+        }
+    }
+    _replay.runs.push_back({bits, deltaTicks, 1});
+}
+
+bool ReplayRecorder::finish(const string &path) {
+    if (!_active) return false;
+    _active = false;
+    return saveReplay(_replay, path);
+}
+
+ReplayPlayer::ReplayPlayer(Replay replay) : _replay(std::move(replay)), _tick(_replay.startTick) {
+    while (!finished() && _replay.runs[_run].count == 0) _run++;
+}
+
+int64_t ReplayPlayer::nextTick() const {
+    return _tick + _replay.runs[_run].deltaTicks;
+}
+
+bool ReplayPlayer::finished() const {
+    return _run >= _replay.runs.size();
+}
+
+bool ReplayPlayer::next(InputSnapshot &input, int64_t &tick) {
+    if (finished()) return false;
+
+    const auto &run = _replay.runs[_run];
+    _tick += run.deltaTicks;
+    input = unpackInput(run.input);
+    tick = _tick;
+
+    // Step past this run (and any empty ones) so finished() and nextTick() see the next tick
+    if (++_runTick >= run.count) {
+        _runTick = 0;
+        _run++;
+    }
+    while (!finished() && _replay.runs[_run].count == 0) _run++;
+    return true;
+}
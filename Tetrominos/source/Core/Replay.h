@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "InputSnapshot.h"
+
+// Replays (.tcr) hold everything needed to re-run a game: the seed, the
+// GameConfig, the simulation tick rate, and the InputSnapshot and tick number
+// of every simulated tick. The game clock is derived from the tick number, so
+// a replay reproduces the game exactly.
+//
+// Ticks are run-length encoded as (input bits, ticks since previous, count).
+// Live games step every tick, so a run lasts as long as the keys stay the same.
+// Version 1 and 2 files recorded one tick per frame in whole milliseconds; they
+// load as a 1000 Hz recording with gaps between ticks.
+
+// One run of identical ticks.
+struct ReplayRun {
+    uint8_t input{};
+    uint32_t deltaTicks{};
+    uint32_t count{};
+};
+
+struct Replay {
+    uint64_t seed{};
+    GameConfig config;
+    int tickRate{DEFAULT_TICK_RATE};
+    int64_t startTick{}; // the clock reads startTick / tickRate when the game starts
+    std::vector<ReplayRun> runs;
+};
+
+[[nodiscard]] uint8_t packInput(const InputSnapshot &input);
+[[nodiscard]] InputSnapshot unpackInput(uint8_t bits);
+
+[[nodiscard]] bool saveReplay(const Replay &replay, const std::string &path);
+[[nodiscard]] bool loadReplay(Replay &replay, const std::string &path);
+
+class ReplayRecorder {
+public:
+    void begin(uint64_t seed, const GameConfig &config, int tickRate, int64_t startTick);
+    void record(const InputSnapshot &input, int64_t tick);
+    // Writes the recording (if one is in progress) and stops recording.
+    bool finish(const std::string &path);
+    [[nodiscard]] bool active() const { return _active; }
+
+private:
+    Replay _replay;
+    int64_t _lastTick{};
+    bool _active{};
+};
+
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(Replay replay);
+
+    [[nodiscard]] const Replay &replay() const { return _replay; }
+    // Tick number of the next recorded tick; only valid while !finished().
+    [[nodiscard]] int64_t nextTick() const;
+    // Next recorded tick's input and tick number; false once the recording is exhausted.
+    [[nodiscard]] bool next(InputSnapshot &input, int64_t &tick);
+    [[nodiscard]] bool finished() const;
+
+private:
+    Replay _replay;
+    size_t _run{};
+    uint32_t _runTick{};
+    int64_t _tick{};
+};
@@ -0,0 +1,40 @@
+#include "Rng.h"
+
+#include <random>
+
+using namespace std;
+
+void Rng::seed(const uint64_t seedValue) {
+    _state = 0;
+    (void)next();
+    _state += seedValue;
+    (void)next();
+}
+
+uint32_t Rng::next() {
+    const uint64_t old = _state;
+    _state = old * kMultiplier + kIncrement;
+    const auto xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+    const auto rot = static_cast<uint32_t>(old >> 59u);
+    return (xorShifted >> rot) | (xorShifted << ((32u - rot) & 31u));
+}
+
+int Rng::getInteger(const int min, const int max) {
+    const uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1u;
+    if (range == 0) return static_cast<int>(next()); // full 32-bit range
+
+    // Reject the low values that would make some results one draw more likely
+    const uint32_t threshold = (0u - range) % range;
+    uint32_t value = next();
+    while (value < threshold)
+        value = next();
+    return static_cast<int>(static_cast<uint32_t>(min) + value % range);
+}
+
+uint64_t Rng::makeSeed() {
+    random_device device;
+    uint64_t seedValue = 0;
+    while (seedValue == 0)
+        seedValue = (static_cast<uint64_t>(device()) << 32) | device();
+    return seedValue;
+}
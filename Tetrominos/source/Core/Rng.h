@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// PCG32 (XSH-RR) pseudo-random generator. Eight bytes of state and trivially
+// copyable, so each GameState carries its own and a game is reproducible from
+// its seed regardless of what other games or threads are doing.
+class Rng {
+public:
+    Rng() { seed(0); }
+    explicit Rng(const uint64_t seedValue) { seed(seedValue); }
+
+    void seed(uint64_t seedValue);
+    [[nodiscard]] uint32_t next();
+    // Uniform integer in [min, max], without modulo bias.
+    [[nodiscard]] int getInteger(int min, int max);
+
+    // A fresh nonzero seed from the system entropy source.
+    [[nodiscard]] static uint64_t makeSeed();
+
+private:
+    static constexpr uint64_t kMultiplier = 6364136223846793005ULL;
+    static constexpr uint64_t kIncrement = 1442695040888963407ULL;
+
+    uint64_t _state{};
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Clock.h"
+#include "GameTypes.h"
+#include "InputSnapshot.h"
+#include "SoundEngine.h"
+
+// Keys held by one player, read once per frame.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    [[nodiscard]] virtual InputSnapshot poll() = 0;
+    // Appends the keys since the last call to `out`, oldest first, each at the
+    // time it was read. A source that only knows the keys of the moment
+    // reports poll() as one event at `now`.
+    virtual void takeEvents(const double now, std::vector<KeyEvent> &out) { out.push_back({now, poll()}); }
+    // A menu reads the terminal itself between suspend() and resume(), so a
+    // source that reads it on its own thread stops meanwhile. Keys read before
+    // suspend() that nobody took are dropped.
+    virtual void suspend() {}
+    virtual void resume() {}
+};
+
+// Sound effects, music and their settings for one player.
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    virtual void playSound(GameSound sound) = 0;
+    virtual void playMusic(const std::string &track) = 0;
+    virtual void pauseMusic() = 0;
+    virtual void unpauseMusic() = 0;
+    virtual void stopMusic() = 0;
+    [[nodiscard]] virtual bool musicEnded() const = 0;
+    [[nodiscard]] virtual std::string currentMusic() const = 0;
+
+    virtual void setMusicVolume(float volume) = 0;
+    virtual void setEffectVolume(float volume) = 0;
+    virtual void setSoundtrackMode(SoundtrackMode mode) = 0;
+    [[nodiscard]] virtual float musicVolume() const = 0;
+    [[nodiscard]] virtual float effectVolume() const = 0;
+    [[nodiscard]] virtual SoundtrackMode soundtrackMode() const = 0;
+};
+
+// A character terminal of one player: colored text at cell positions.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    virtual void clear() = 0;
+    virtual void moveTo(int x, int y) = 0; // 1-based, like rlutil::locate
+    virtual void setColor(int foreground, int background) = 0;
+    virtual void write(std::string_view text) = 0;
+    virtual void flush() = 0;
+    // Top-left corner of the game area, which is centered in a larger terminal.
+    [[nodiscard]] virtual int originX() const = 0;
+    [[nodiscard]] virtual int originY() const = 0;
+};
+
+// Everything one game talks to outside its own state: a wall clock for frame
+// pacing, an input source, an audio sink and an output sink. Tetrominos and
+// GameRenderer take these instead of reaching for process-wide singletons, so
+// several games can share a process. The console build wraps the KonsoleGE
+// singletons in a single ConsoleSession (ConsoleSession.h).
+struct Session {
+    const Clock &clock;
+    InputSource &input;
+    AudioSink &audio;
+    OutputSink &output;
+};
@@ -0,0 +1,75 @@
+#include "SimState.h"
+
+#include <type_traits>
+
+#include "Color.h"
+#include "GameState.h"
+
+using namespace std;
+
+static_assert(is_trivially_copyable_v<SimState>);
+static_assert(sizeof(SimState) <= 128);
+static_assert(SimState::kQueueLength <= static_cast<int>(PieceQueue::kCapacity));
+
+static uint8_t pieceCode(const optional<Tetrimino> &piece) {
+    return piece ? static_cast<uint8_t>(piece->getType()) : SimState::kNoPiece;
+}
+
+SimState SimState::capture(const GameState &state) {
+    SimState s;
+    s.storeMatrix(state.matrix);
+
+    const Stats &stats = state.stats;
+    s.score = stats.score;
+    s.minos = stats.nbMinos;
+    s.lines = static_cast<int16_t>(stats.lines);
+    s.goal = static_cast<int16_t>(stats.goal);
+    s.quads = static_cast<uint16_t>(stats.quad);
+    s.combos = static_cast<uint16_t>(stats.combos);
+    s.tSpins = static_cast<uint16_t>(stats.tSpins);
+    s.currentCombo = static_cast<int8_t>(stats.currentCombo);
+    s.level = static_cast<uint8_t>(stats.level);
+
+    for (int i = 0; i < kQueueLength; i++)
+        s.queue |= static_cast<uint64_t>(state.pieces.queue.peek(static_cast<size_t>(i))) << (4 * i);
+    s.hold = pieceCode(state.pieces.hold);
+    s.current = pieceCode(state.pieces.current);
+    if (const auto &current = state.pieces.current) {
+        s.rotation = static_cast<uint8_t>(current->getRotation());
+        s.row = static_cast<int8_t>(current->getPosition().row);
+        s.column = static_cast<int8_t>(current->getPosition().column);
+        s.lastRotationPoint = static_cast<int8_t>(current->getLastRotationPoint());
+    }
+    s.fallProgress = static_cast<uint32_t>(state.pieces.fallProgress);
+
+    s.lockMoves = static_cast<uint8_t>(state.lockDown.moveCount);
+    s.lockLowestRow = static_cast<int8_t>(state.lockDown.lowestLine);
+    s.phase = static_cast<uint8_t>(state.phase);
+    s.stepState = static_cast<uint8_t>(state.flags.stepState);
+
+    const auto flag = [&s](const bool set, const Flag f) {
+        if (set) s.flags |= f;
+    };
+    flag(state.pieces.isNewHold, HoldUsed);
+    flag(stats.backToBackBonus, BackToBack);
+    flag(state.lockDown.active, LockDownActive);
+    flag(state.flags.lastMoveIsTSpin, TSpin);
+    flag(state.flags.lastMoveIsMiniTSpin, MiniTSpin);
+    flag(state.flags.isGameOver, GameOver);
+    flag(state.flags.didRotate, DidRotate);
+    return s;
+}
+
+void SimState::storeMatrix(const GameMatrix &matrix) {
+    for (int r = 0; r < BOARD_HEIGHT; r++) rows[static_cast<size_t>(r)] = matrix.rowMask(r);
+}
+
+GameMatrix SimState::matrix() const {
+    GameMatrix matrix;
+    matrix.loadRows(rows, Color::GREY);
+    return matrix;
+}
+
+Tetrimino SimState::piece() const {
+    return {static_cast<PieceType>(current), static_cast<Rotation>(rotation), {row, column}, lastRotationPoint};
+}
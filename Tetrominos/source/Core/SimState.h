@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Constants.h"
+#include "GameMatrix.h"
+#include "PieceData.h"
+#include "Tetrimino.h"
+
+class GameState;
+
+// The hot part of a GameState packed into one 128-byte, trivially copyable
+// value (two cache lines), so millions of positions can sit in flat arrays for
+// search and batch simulation and be copied with memcpy.
+//
+// The matrix is kept as its row masks only; cell colors, highscores, options,
+// the player name, pending sounds, line-clear texts, the hard-drop trail and
+// the game timer are cold state that stays in GameState. The randomizer is not
+// captured either: a SimState knows the next kQueueLength pieces and nothing
+// past them. GameState::restore(const SimState &) writes one back.
+struct alignas(64) SimState {
+    static constexpr int kQueueLength = 16; // 4 bits per piece in `queue`
+    static constexpr uint8_t kNoPiece = 0xF;
+
+    enum Flag : uint8_t {
+        HoldUsed = 1 << 0,
+        BackToBack = 1 << 1,
+        LockDownActive = 1 << 2,
+        TSpin = 1 << 3,
+        MiniTSpin = 1 << 4,
+        GameOver = 1 << 5,
+        DidRotate = 1 << 6,
+    };
+
+    std::array<uint16_t, BOARD_HEIGHT> rows{}; // GameMatrix::rowMask, walls included
+    int64_t score{};
+    uint64_t queue{}; // upcoming pieces, the next one in the low nibble
+    uint32_t fallProgress{};
+    int32_t minos{};
+    int16_t lines{};
+    int16_t goal{};
+    uint16_t quads{};
+    uint16_t combos{};
+    uint16_t tSpins{};
+    int8_t currentCombo{-1};
+    uint8_t level{};
+    uint8_t phase{};
+    uint8_t current{kNoPiece};
+    uint8_t rotation{};
+    int8_t row{};
+    int8_t column{};
+    int8_t lastRotationPoint{-1};
+    uint8_t hold{kNoPiece};
+    uint8_t lockMoves{};
+    int8_t lockLowestRow{};
+    uint8_t stepState{};
+    uint8_t flags{};
+
+    [[nodiscard]] static SimState capture(const GameState &state);
+
+    void storeMatrix(const GameMatrix &matrix);
+    // Occupancy only: every filled cell gets the same color.
+    [[nodiscard]] GameMatrix matrix() const;
+
+    [[nodiscard]] PieceType queued(const int n) const {
+        return static_cast<PieceType>((queue >> (4 * n)) & 0xF);
+    }
+    [[nodiscard]] bool hasCurrent() const { return current != kNoPiece; }
+    [[nodiscard]] Tetrimino piece() const;
+    [[nodiscard]] bool has(const Flag flag) const { return (flags & flag) != 0; }
+};
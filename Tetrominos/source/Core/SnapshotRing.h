@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "GameState.h"
+
+// The last kCapacity game snapshots, newest on top. Pushing onto a full ring
+// overwrites the oldest one. Slots are reused, so nothing is allocated.
+class SnapshotRing {
+public:
+    static constexpr size_t kCapacity = 32;
+
+    void clear() { _size = 0; }
+    // The slot to fill with the next snapshot; it becomes the newest.
+    [[nodiscard]] GameSnapshot &push() {
+        _top = (_top + 1) % kCapacity;
+        if (_size < kCapacity) _size++;
+        return _slots[_top];
+    }
+    void pop() {
+        if (_size == 0) return;
+        _top = (_top + kCapacity - 1) % kCapacity;
+        _size--;
+    }
+    [[nodiscard]] const GameSnapshot &top() const { return _slots[_top]; }
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+private:
+    std::array<GameSnapshot, kCapacity> _slots{};
+    size_t _top{kCapacity - 1};
+    size_t _size{};
+};
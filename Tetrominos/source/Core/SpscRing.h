@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// A fixed-size queue from one producer thread to one consumer thread, without
+// locks: each side advances its own index and reads the other's with acquire
+// ordering, so an item is complete before the consumer can see it. Pushing
+// onto a full ring fails and drops the item. Slots are reused, so nothing is
+// allocated.
+template <class T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+
+public:
+    // Producer only.
+    [[nodiscard]] bool push(const T &item) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity) return false;
+        _slots[tail % Capacity] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    [[nodiscard]] bool pop(T &item) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) return false;
+        item = _slots[head % Capacity];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> _slots{};
+    alignas(64) std::atomic<size_t> _head{}; // each index on its own cache line
+    alignas(64) std::atomic<size_t> _tail{};
+};
@@ -1,72 +1,286 @@
 #include "Tetrominos.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "HighScoreDisplay.h"
-#include "Random.h"
-#include "Timer.h"
 #include "Menu.h"
-#include "SoundEngine.h"
-#include "rlutil.h"
+#include "Platform.h"
 
-Tetrominos::Tetrominos(Menu &pauseMenu, Menu &gameOverMenu, HighScoreDisplay &highScoreDisplay)
-    : _controller(Timer::instance()), _pauseMenu(pauseMenu), _gameOverMenu(gameOverMenu),
-      _highScoreDisplay(highScoreDisplay) {
-    _state.loadOptions();
-    _state.loadHighscore();
+// The clock on screen is repainted at most this often
+static constexpr double kFrameInterval = TickDriver::kFrameInterval;
+static constexpr double kMaxWait = 0.1; // seconds; the music's end is noticed no later than this
+
+// The game's files live in the platform data directory; the core takes their paths from here
+static std::string dataFile(const char *name) {
+    return Platform::getDataDir() + "/" + name;
+}
+
+// The clock on screen shows the game time rounded to centiseconds (Utility::timeToString)
+static int64_t centiseconds(const double seconds) {
+    return std::llround(seconds * 100);
+}
+
+Tetrominos::Tetrominos(const Session &session, Menu &pauseMenu, Menu &gameOverMenu,
+                       HighScoreDisplay &highScoreDisplay)
+    : _session(session), _state(_ticks.clock()), _renderer(session.output), _controller(_ticks.clock()),
+      _pauseMenu(pauseMenu), _gameOverMenu(gameOverMenu), _highScoreDisplay(highScoreDisplay),
+      _trackRng(Rng::makeSeed()) {
+    _state.loadOptions(dataFile("options.bin"));
+    _state.loadHighscore(dataFile("score.bin"));
+
+    if (_state.sound) {
+        _session.audio.setMusicVolume(static_cast<float>(_state.sound->musicVolume) * 0.02f);
+        _session.audio.setEffectVolume(static_cast<float>(_state.sound->effectVolume) * 0.1f);
+        _session.audio.setSoundtrackMode(static_cast<SoundtrackMode>(_state.sound->soundtrackMode));
+    }
 }
 
 Tetrominos::~Tetrominos() = default;
 
+void Tetrominos::saveOptions() {
+    SoundOptions opts;
+    opts.musicVolume = static_cast<int>(lround(_session.audio.musicVolume() * 50));
+    opts.effectVolume = static_cast<int>(lround(_session.audio.effectVolume() * 10));
+    opts.soundtrackMode = static_cast<int>(_session.audio.soundtrackMode());
+    _state.sound = opts;
+    _state.saveOptions(dataFile("options.bin"));
+}
+
+void Tetrominos::setTickRate(const int hz) {
+    _tickRate = std::clamp(hz, MIN_TICK_RATE, MAX_TICK_RATE);
+}
+
+int Tetrominos::tickRate() const {
+    return _playback ? _playback->replay().tickRate : _tickRate;
+}
+
+void Tetrominos::resetClock(const int64_t tick) {
+    _lastFrame = _session.clock.now();
+    _ticks.reset(tickRate(), tick, _lastFrame);
+}
+
+// Drops the wall time spent outside the tick loop (menus, a too-small terminal)
+// so the clock does not try to catch up on it.
+void Tetrominos::resyncFrame() {
+    _lastFrame = _session.clock.now();
+    _ticks.resync(_lastFrame);
+}
+
+void Tetrominos::pauseGameTimer() {
+    _state.pauseGameTimer();
+}
+
+void Tetrominos::resumeGameTimer() {
+    resyncFrame();
+    _state.resumeGameTimer();
+}
+
+void Tetrominos::beginRecording() {
+    if (_recordingEnabled && !_playback && !_state.config.practice)
+        _recorder.begin(_state.seed, _state.config, _tickRate, _ticks.tick());
+}
+
+void Tetrominos::finishRecording() {
+    if (_recorder.active()) (void)_recorder.finish(dataFile("last.tcr"));
+}
+
+void Tetrominos::startPlayback(Replay replay) {
+    _configBeforePlayback = _state.config;
+    _state.config = replay.config;
+    _playback.emplace(std::move(replay));
+}
+
+void Tetrominos::stopPlayback() {
+    _session.input.suspend();
+    _playback.reset();
+    _state.config = _configBeforePlayback;
+    _session.audio.stopMusic();
+    _backToMenu = true;
+}
+
 void Tetrominos::start() {
+    resetClock(_playback ? _playback->replay().startTick : 0);
     _controller.configurePolicies(_state.config.mode);
     _controller.configureVariant(_state.config.variant, _state);
+    _controller.setTickRate(tickRate());
     _renderer.configure(_state.config.previewCount, _state.config.holdEnabled, _state.config.showGoal);
     _controller.start(_state);
+    _undo.clear();
     _renderer.invalidate();
     _renderer.render(_state);
     playStartingMusic();
+    beginRecording();
+    _session.input.resume();
 }
 
-void Tetrominos::step(const InputSnapshot &input) {
-    const StepResult result = _controller.step(_state, input);
+// Fixed-timestep loop: the clock advances one tick per 1 / tickRate() seconds
+// of wall time (TickDriver). A live game steps only the ticks where something
+// happens (play()), a replay every recorded tick. Rendering happens once per
+// frame afterwards, from the last tick.
+void Tetrominos::step() {
+    const double now = _session.clock.now();
+    _events.clear();
+    _session.input.takeEvents(now, _events);
+    _lastFrame = now;
 
-    playPendingSounds();
+    bool running = true;
+    if (_playback) {
+        const bool pausePressed = std::any_of(_events.begin(), _events.end(), [](const KeyEvent &event) {
+            return event.keys.pause;
+        });
+        const int64_t current = _ticks.catchUp(now, _ticks.tick() + 1);
+        while (running && _ticks.tick() < current) running = advanceTick(pausePressed);
+    } else {
+        running = play(now);
+    }
+    if (!running) resyncFrame();
 
-    if (SoundEngine::musicEnded()) {
-        const auto &name = SoundEngine::currentMusicName();
-        switch (SoundEngine::getSoundtrackMode()) {
+    if (_session.audio.musicEnded()) {
+        const std::string name = _session.audio.currentMusic();
+        switch (_session.audio.soundtrackMode()) {
             case SoundtrackMode::Cycle:
-                if (name == "A") SoundEngine::playMusic("B");
-                else if (name == "B") SoundEngine::playMusic("C");
-                else if (name == "C") SoundEngine::playMusic("A");
+                if (name == "A") _session.audio.playMusic("B");
+                else if (name == "B") _session.audio.playMusic("C");
+                else if (name == "C") _session.audio.playMusic("A");
                 break;
             case SoundtrackMode::Random:
-                SoundEngine::playMusic(randomTrack(name));
+                _session.audio.playMusic(randomTrack(name));
                 break;
-            case SoundtrackMode::TrackA: SoundEngine::playMusic("A"); break;
-            case SoundtrackMode::TrackB: SoundEngine::playMusic("B"); break;
-            case SoundtrackMode::TrackC: SoundEngine::playMusic("C"); break;
+            case SoundtrackMode::TrackA: _session.audio.playMusic("A"); break;
+            case SoundtrackMode::TrackB: _session.audio.playMusic("B"); break;
+            case SoundtrackMode::TrackC: _session.audio.playMusic("C"); break;
         }
     }
+}
+
+// Runs the ticks of a live game up to the one the wall time `now` has reached,
+// with this frame's key events, each from the tick it was read on, so a key
+// lands where it was pressed however late this frame comes. The clock ends on
+// that tick, for the clock on screen. Every tick is recorded, stepped or not.
+bool Tetrominos::play(const double now) {
+    const int64_t current = _ticks.catchUp(now, nextStep());
+    return _ticks.play(_events, current, true, [this] { return _controller.nextDeadline(_state); },
+                       [this](const int64_t from, const int64_t tick, const InputSnapshot &input) {
+                           if (_recorder.active())
+                               for (int64_t skipped = from; skipped <= tick; skipped++)
+                                   _recorder.record(input, skipped);
+                           return runTick(input);
+                       });
+}
+
+int64_t Tetrominos::nextStep() const {
+    return _ticks.nextStep(_controller.nextDeadline(_state));
+}
+
+// The tick at which the clock on screen next shows another centisecond: the
+// game time crosses half a centisecond, upwards or, with a time limit, down.
+int64_t Tetrominos::clockChangeTick() const {
+    if (!_state.gameTimerRunning()) return NO_DEADLINE;
+    const double shown = _state.displayTime();
+    const double edge = static_cast<double>(centiseconds(shown)) / 100 + (_state.config.timeLimit > 0 ? -0.005 : 0.005);
+    const auto ticks = static_cast<int64_t>(std::ceil(std::abs(edge - shown) * static_cast<double>(_ticks.tickRate())));
+    return _ticks.tick() + std::max<int64_t>(1, ticks);
+}
+
+double Tetrominos::nextWake() const {
+    const double frame = _lastFrame + kFrameInterval;
+    if (_playback) return frame;
+    // Keys show on the tick they take effect
+    if (_ticks.heldFrom() > _ticks.tick()) return _ticks.tickTime(_ticks.heldFrom());
+    const int64_t tick = std::min(nextStep(), clockChangeTick());
+    return std::clamp(_ticks.tickTime(tick), frame, _lastFrame + kMaxWait);
+}
+
+// Replays: advances the clock one tick and steps every recorded tick that is
+// due. Returns false when the tick loop has to stop (playback ended or left).
+bool Tetrominos::advanceTick(const bool pausePressed) {
+    _ticks.setTick(_ticks.tick() + 1);
+
+    if (pausePressed) {
+        stopPlayback();
+        return false;
+    }
+
+    // Version 1-2 recordings have gaps between ticks; the clock runs on without stepping
+    while (!_playback->finished() && _playback->nextTick() <= _ticks.tick()) {
+        InputSnapshot input;
+        int64_t recorded = 0;
+        (void)_playback->next(input, recorded);
+        if (!runTick(input)) return false;
+    }
+
+    if (_playback->finished()) {
+        stopPlayback();
+        return false;
+    }
+    return true;
+}
+
+bool Tetrominos::runTick(const InputSnapshot &input) {
+    // The game timer resumes on the first tick after a pause, live or replayed
+    if (_ticks.takeResume()) _state.resumeGameTimer();
+
+    if (_state.config.practice) {
+        const bool undoPressed = input.undo && !_wasUndoPressed;
+        _wasUndoPressed = input.undo;
+        if (undoPressed) {
+            undoPiece();
+            return true;
+        }
+    }
+
+    const GamePhase phaseBefore = _state.phase;
+    const StepResult result = _controller.step(_state, input);
+    if (_state.config.practice && phaseBefore == GamePhase::Generation && _state.phase == GamePhase::Falling)
+        _controller.snapshot(_state, _undo.push());
+
+    playPendingSounds();
+
+    const bool wasPausePressed = _wasPausePressed;
+    _wasPausePressed = input.pause;
 
     switch (result) {
         case StepResult::Continue: break;
         case StepResult::PauseRequested:
-            if (!_wasPausePressed) handlePause();
-            break;
-        case StepResult::GameOver: handleGameOver(); break;
+            if (wasPausePressed) break;
+            if (_playback) {
+                _state.pauseGameTimer();
+                _ticks.resumeOnNextTick();
+                break;
+            }
+            handlePause();
+            return false;
+        case StepResult::GameOver:
+            if (_playback)
+                stopPlayback();
+            else
+                handleGameOver();
+            return false;
     }
-    _wasPausePressed = input.pause;
+    return true;
+}
+
+// Back to the spawn of the last piece that was placed. While a piece is
+// falling, the newest snapshot is its own spawn, so it is dropped first; the
+// first piece of a game just goes back to its spawn.
+void Tetrominos::undoPiece() {
+    if (_undo.empty()) return;
+    if (_state.phase == GamePhase::Falling && _undo.size() > 1) _undo.pop();
+    _controller.restore(_state, _undo.top());
+    _session.audio.playSound(GameSound::Click);
 }
 
 void Tetrominos::render() {
+    const int64_t shown = centiseconds(_state.displayTime());
     if (_state.isDirty()) {
         _renderer.render(_state);
         _state.clearDirty();
-    } else {
+    } else if (shown != _shownTime) {
         _renderer.renderTimer(_state);
     }
+    _shownTime = shown;
 }
 
 void Tetrominos::redraw() {
@@ -76,9 +290,11 @@ void Tetrominos::redraw() {
     _state.clearDirty();
 }
 
+// The menus read the keys themselves until the game resumes.
 void Tetrominos::handlePause() {
+    _session.input.suspend();
     _state.pauseGameTimer();
-    SoundEngine::pauseMusic();
+    _session.audio.pauseMusic();
     _renderer.render(_state, false);
     _state.clearDirty();
 
@@ -86,18 +302,24 @@ void Tetrominos::handlePause() {
     const auto &selected = choices.options[choices.selected];
 
     if (selected == "Restart") {
-        SoundEngine::stopMusic();
+        finishRecording();
+        _session.audio.stopMusic();
+        resetClock(0);
         _controller.start(_state);
+        _undo.clear();
         _renderer.configure(_state.config.previewCount, _state.config.holdEnabled, _state.config.showGoal);
         _renderer.invalidate();
         _renderer.render(_state);
         _state.clearDirty();
         playStartingMusic();
+        beginRecording();
+        _session.input.resume();
         return;
     }
 
     if (selected == "Main Menu") {
-        SoundEngine::stopMusic();
+        finishRecording();
+        _session.audio.stopMusic();
         _backToMenu = true;
         return;
     }
@@ -106,26 +328,30 @@ void Tetrominos::handlePause() {
     _renderer.render(_state);
     _state.clearDirty();
 
-    const auto &current = SoundEngine::currentMusicName();
-    switch (SoundEngine::getSoundtrackMode()) {
+    const std::string current = _session.audio.currentMusic();
+    switch (_session.audio.soundtrackMode()) {
         case SoundtrackMode::TrackA:
-            if (current != "A") SoundEngine::playMusic("A"); else SoundEngine::unpauseMusic();
+            if (current != "A") _session.audio.playMusic("A"); else _session.audio.unpauseMusic();
             break;
         case SoundtrackMode::TrackB:
-            if (current != "B") SoundEngine::playMusic("B"); else SoundEngine::unpauseMusic();
+            if (current != "B") _session.audio.playMusic("B"); else _session.audio.unpauseMusic();
             break;
         case SoundtrackMode::TrackC:
-            if (current != "C") SoundEngine::playMusic("C"); else SoundEngine::unpauseMusic();
+            if (current != "C") _session.audio.playMusic("C"); else _session.audio.unpauseMusic();
             break;
-        default: SoundEngine::unpauseMusic(); break;
+        default: _session.audio.unpauseMusic(); break;
     }
 
-    _state.resumeGameTimer();
+    // Resumed by the next step(), at a tick time a replay can reproduce
+    _ticks.resumeOnNextTick();
+    _session.input.resume();
 }
 
 void Tetrominos::handleGameOver() {
+    _session.input.suspend();
     _state.pauseGameTimer();
-    SoundEngine::stopMusic();
+    finishRecording();
+    _session.audio.stopMusic();
     if (_state.stats.hasBetterHighscore) {
         HighScoreRecord rec{};
         rec.score = _state.stats.score;
@@ -142,13 +368,14 @@ void Tetrominos::handleGameOver() {
         rec.ghostEnabled = _state.config.ghostEnabled;
         rec.holdEnabled = _state.config.holdEnabled;
         rec.previewCount = _state.config.previewCount;
-        rlutil::cls();
+        rec.seed = _state.seed;
+        _session.output.clear();
         GameRenderer::renderTitle("A classic in console!");
         _state.setPlayerName(_highScoreDisplay.openForNewEntry(_state.allHighscores(), rec, _state.config.variant));
-        rlutil::cls();
+        _session.output.clear();
         GameRenderer::renderTitle("A classic in console!");
     }
-    _state.saveHighscore();
+    _state.saveHighscore(dataFile("score.bin"));
 
     const OptionChoice choices = _gameOverMenu.open(_state.stats.hasBetterHighscore);
     const auto &selected = choices.options[choices.selected];
@@ -158,24 +385,20 @@ void Tetrominos::handleGameOver() {
         return;
     }
 
+    resetClock(0);
     _controller.start(_state);
+    _undo.clear();
     _renderer.configure(_state.config.previewCount, _state.config.holdEnabled, _state.config.showGoal);
     _renderer.invalidate();
     _renderer.render(_state);
     _state.clearDirty();
     playStartingMusic();
+    beginRecording();
+    _session.input.resume();
 }
 
 void Tetrominos::playPendingSounds() {
-    for (const auto sound : _state.pendingSounds()) {
-        switch (sound) {
-            case GameSound::Click: SoundEngine::playSound("CLICK"); break;
-            case GameSound::Lock: SoundEngine::playSound("LOCK"); break;
-            case GameSound::HardDrop: SoundEngine::playSound("HARD_DROP"); break;
-            case GameSound::LineClear: SoundEngine::playSound("LINE_CLEAR"); break;
-            case GameSound::Quad: SoundEngine::playSound("QUAD"); break;
-        }
-    }
+    for (const auto sound : _state.pendingSounds()) _session.audio.playSound(sound);
     _state.clearPendingSounds();
 }
 
@@ -184,15 +407,15 @@ std::string Tetrominos::randomTrack(const std::string &exclude) {
     std::vector<std::string> choices;
     for (const auto &t : tracks)
         if (t != exclude) choices.push_back(t);
-    return choices[static_cast<size_t>(Random::getInteger(0, static_cast<int>(choices.size()) - 1))];
+    return choices[static_cast<size_t>(_trackRng.getInteger(0, static_cast<int>(choices.size()) - 1))];
 }
 
 void Tetrominos::playStartingMusic() {
-    switch (SoundEngine::getSoundtrackMode()) {
-        case SoundtrackMode::Cycle: SoundEngine::playMusic("A"); break;
-        case SoundtrackMode::Random: SoundEngine::playMusic(randomTrack()); break;
-        case SoundtrackMode::TrackA: SoundEngine::playMusic("A"); break;
-        case SoundtrackMode::TrackB: SoundEngine::playMusic("B"); break;
-        case SoundtrackMode::TrackC: SoundEngine::playMusic("C"); break;
+    switch (_session.audio.soundtrackMode()) {
+        case SoundtrackMode::Cycle: _session.audio.playMusic("A"); break;
+        case SoundtrackMode::Random: _session.audio.playMusic(randomTrack()); break;
+        case SoundtrackMode::TrackA: _session.audio.playMusic("A"); break;
+        case SoundtrackMode::TrackB: _session.audio.playMusic("B"); break;
+        case SoundtrackMode::TrackC: _session.audio.playMusic("C"); break;
     }
 }
@@ -1,23 +1,47 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+
+#include "Clock.h"
 #include "GameState.h"
 #include "GameRenderer.h"
 #include "GameController.h"
+#include "Replay.h"
+#include "Rng.h"
+#include "Session.h"
+#include "SnapshotRing.h"
+#include "TickDriver.h"
 
 class HighScoreDisplay;
 class Menu;
 
 class Tetrominos {
 public:
-    Tetrominos(Menu &pauseMenu, Menu &gameOverMenu, HighScoreDisplay &highScoreDisplay);
+    Tetrominos(const Session &session, Menu &pauseMenu, Menu &gameOverMenu, HighScoreDisplay &highScoreDisplay);
     ~Tetrominos();
 
     void start();
-    void step(const InputSnapshot &input);
+    // Polls the session's input and runs the ticks that are due.
+    void step();
+    // Draws what changed: everything when the state is dirty, else the clock
+    // and rates once the clock on screen shows another centisecond.
     void render();
+    // Session clock time at which step() and render() next have something to
+    // do if no key arrives first: the next tick the game steps, or the next
+    // centisecond of the clock on screen but no sooner than a frame after this
+    // one. The console build blocks on input until then.
+    [[nodiscard]] double nextWake() const;
     void redraw();
-    void pauseGameTimer() { _state.pauseGameTimer(); }
-    void resumeGameTimer() { _state.resumeGameTimer(); }
+    void pauseGameTimer();
+    void resumeGameTimer();
+    void setRecording(const bool enabled) { _recordingEnabled = enabled; }
+    // Simulation ticks per second for new games; replays run at their recorded rate.
+    void setTickRate(int hz);
+    // Play the replay back instead of reading input; returns to the menu when it ends.
+    void startPlayback(Replay replay);
+    [[nodiscard]] bool isPlayingBack() const { return _playback.has_value(); }
+    [[nodiscard]] const GameState &state() const { return _state; }
     void exit() { _state.setShouldExit(true); }
     [[nodiscard]] bool doExit() const { return _state.shouldExit(); }
     [[nodiscard]] bool backToMenu() const { return _backToMenu; }
@@ -27,25 +51,52 @@ public:
     void setVariant(const GameVariant variant) { _state.config.variant = variant; }
     void setGhostEnabled(const bool v) { _state.config.ghostEnabled = v; }
     void setHoldEnabled(const bool v) { _state.config.holdEnabled = v; }
+    void setSonicDrop(const bool v) { _state.config.sonicDrop = v; }
     void setPreviewCount(const int n) { _state.config.previewCount = n; }
+    void setPractice(const bool v) { _state.config.practice = v; }
     [[nodiscard]] int startingLevel() const { return _state.config.startingLevel; }
     [[nodiscard]] LockDownMode mode() const { return _state.config.mode; }
     [[nodiscard]] GameVariant variant() const { return _state.config.variant; }
     [[nodiscard]] bool ghostEnabled() const { return _state.config.ghostEnabled; }
     [[nodiscard]] bool holdEnabled() const { return _state.config.holdEnabled; }
+    [[nodiscard]] bool sonicDrop() const { return _state.config.sonicDrop; }
     [[nodiscard]] int previewCount() const { return _state.config.previewCount; }
+    [[nodiscard]] bool practice() const { return _state.config.practice; }
     [[nodiscard]] const std::vector<HighScoreRecord> &highscores() const { return _state.highscores(); }
     [[nodiscard]] const HighScoreTable &allHighscores() const { return _state.allHighscores(); }
     void setPlayerName(const std::string &n) { _state.setPlayerName(n); }
-    void saveOptions() const { _state.saveOptions(); }
+    void saveOptions();
+    [[nodiscard]] AudioSink &audio() const { return _session.audio; }
 
 private:
     void handlePause();
     void handleGameOver();
     void playPendingSounds();
     void playStartingMusic();
-    static std::string randomTrack(const std::string &exclude = "");
+    [[nodiscard]] std::string randomTrack(const std::string &exclude = "");
+    [[nodiscard]] int tickRate() const;
+    void resetClock(int64_t tick);
+    void resyncFrame();
+    [[nodiscard]] bool play(double now);
+    [[nodiscard]] int64_t nextStep() const;
+    [[nodiscard]] int64_t clockChangeTick() const;
+    [[nodiscard]] bool advanceTick(bool pausePressed);
+    [[nodiscard]] bool runTick(const InputSnapshot &input);
+    void beginRecording();
+    void finishRecording();
+    void stopPlayback();
+    void undoPiece();
 
+    // The game logic reads _ticks.clock(), which advances in fixed ticks of
+    // 1 / tickRate() seconds. step() converts the session's wall time into
+    // ticks through _ticks, so the tick rate does not depend on how fast the
+    // terminal repaints. Replays feed the recorded tick numbers.
+    Session _session;
+    TickDriver _ticks;
+    int _tickRate{DEFAULT_TICK_RATE};
+    double _lastFrame{};
+    std::vector<KeyEvent> _events; // taken from the input by this frame's step()
+    int64_t _shownTime{-1}; // centiseconds on the clock on screen
     GameState _state;
     GameRenderer _renderer;
     GameController _controller;
@@ -54,4 +105,11 @@ private:
     HighScoreDisplay &_highScoreDisplay;
     bool _backToMenu{};
     bool _wasPausePressed{};
+    bool _wasUndoPressed{};
+    SnapshotRing _undo; // practice games: the game at each of the last piece spawns
+    bool _recordingEnabled{};
+    ReplayRecorder _recorder;
+    std::optional<ReplayPlayer> _playback;
+    GameConfig _configBeforePlayback;
+    Rng _trackRng; // picks random soundtracks; never touches the game's Rng
 };
@@ -1,6 +1,51 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "Server.h"
 #include "TetrominosGame.h"
 
-int main() {
-    TetrominosGame game;
+int main(int argc, char **argv) {
+    LaunchOptions options;
+    ServeOptions serveOptions;
+    bool serves = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0) {
+            options.record = true;
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            Replay replay;
+            if (!loadReplay(replay, argv[++i])) {
+                std::cerr << "Cannot read replay " << argv[i] << "\n";
+                return 1;
+            }
+            options.replay = std::move(replay);
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            options.tickRate = std::atoi(argv[++i]);
+            if (options.tickRate < MIN_TICK_RATE || options.tickRate > MAX_TICK_RATE) {
+                std::cerr << "Tick rate must be " << MIN_TICK_RATE << "-" << MAX_TICK_RATE << " Hz\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serves = true;
+            serveOptions.socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            serveOptions.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-sessions") == 0 && i + 1 < argc) {
+            serveOptions.maxSessions = static_cast<size_t>(std::max(std::atoi(argv[++i]), 1));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--record] [--replay <file.tcr>] [--tick-rate <hz>]\n"
+                      << "   or: " << argv[0]
+                      << " --serve <socket> [--threads <n>] [--max-sessions <n>] [--tick-rate <hz>]\n";
+            return 1;
+        }
+    }
+
+    if (serves) {
+        serveOptions.tickRate = options.tickRate;
+        return runServer(serveOptions);
+    }
+
+    TetrominosGame game(std::move(options));
     return game.run();
 }
@@ -1,14 +1,26 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
+#include "Constants.h"
 #include "GameEngine.h"
+#include "Replay.h"
 
+class ConsoleSession;
 class GameMenus;
 class HighScoreDisplay;
 class HelpDisplay;
 class Tetrominos;
-struct InputSnapshot;
+
+// Command-line options: --record saves every game to last.tcr, --replay <file>
+// plays a recording back before showing the main menu, --tick-rate <hz> sets
+// the fixed simulation rate.
+struct LaunchOptions {
+    bool record{};
+    int tickRate{DEFAULT_TICK_RATE};
+    std::optional<Replay> replay;
+};
 
 class TetrominosGame : public GameEngine {
 protected:
@@ -20,19 +32,19 @@ protected:
     void onTerminalRestored() override;
 
 public:
-    TetrominosGame();
+    explicit TetrominosGame(LaunchOptions options = {});
     ~TetrominosGame() override;
     TetrominosGame(const TetrominosGame &) = delete;
     TetrominosGame &operator=(const TetrominosGame &) = delete;
 
 private:
     enum class Screen { MainMenu, Playing };
-    static void bindDefaultKeys();
-    static InputSnapshot pollInputSnapshot();
 
+    std::unique_ptr<ConsoleSession> _console;
     std::unique_ptr<GameMenus> _menus;
     std::unique_ptr<HighScoreDisplay> _highScores;
     std::unique_ptr<HelpDisplay> _help;
     std::unique_ptr<Tetrominos> _game;
     Screen _screen{Screen::MainMenu};
+    LaunchOptions _options;
 };
@@ -0,0 +1,80 @@
+#include "TickDriver.h"
+
+#include <cmath>
+
+#include "Replay.h"
+
+using namespace std;
+
+static bool sameKeys(const InputSnapshot &a, const InputSnapshot &b) {
+    return packInput(a) == packInput(b) && a.undo == b.undo;
+}
+
+bool TickDriver::pressed(const InputSnapshot &keys) {
+    return !sameKeys(keys, InputSnapshot{});
+}
+
+void TickDriver::reset(const int tickRate, const int64_t tick, const double now) {
+    _tickRate = tickRate;
+    setTick(tick);
+    _heldFrom = _heldUntil = tick;
+    _resumePending = false;
+    resync(now);
+}
+
+void TickDriver::resync(const double now) {
+    _epoch = now - static_cast<double>(_tick) / static_cast<double>(_tickRate);
+}
+
+void TickDriver::setTick(const int64_t tick) {
+    _tick = tick;
+    _clock.set(static_cast<double>(tick) / static_cast<double>(_tickRate));
+}
+
+double TickDriver::tickTime(const int64_t tick) const {
+    return _epoch + static_cast<double>(tick) / static_cast<double>(_tickRate);
+}
+
+int64_t TickDriver::tickAt(const double time) const {
+    // The rounding of a wake-up is not late
+    return static_cast<int64_t>(floor((time - _epoch) * static_cast<double>(_tickRate) + 1e-6));
+}
+
+int64_t TickDriver::catchUp(const double now, const int64_t next) {
+    const int64_t current = tickAt(now);
+    const int64_t limit = current - static_cast<int64_t>(kMaxCatchUp * static_cast<double>(_tickRate));
+    if (next >= limit) return current;
+    _epoch += static_cast<double>(limit - next) / static_cast<double>(_tickRate);
+    return current - (limit - next);
+}
+
+// Keys that arrive on the tick a press is still waiting for are pressed
+// together with it, so a press is seen for a whole frame.
+void TickDriver::hold(const InputSnapshot &keys, const int64_t from) {
+    if (_heldFrom == from && _heldUntil > from) {
+        _held = combine(_held, keys);
+    } else if (!sameKeys(keys, _held) || _heldUntil < from) {
+        _held = keys;
+        _heldFrom = from;
+    }
+    const auto ticks = static_cast<int64_t>(kKeyHold * static_cast<double>(_tickRate));
+    _heldUntil = max(_heldUntil, from + max<int64_t>(1, ticks));
+}
+
+InputSnapshot TickDriver::heldInput(const int64_t tick) const {
+    return tick >= _heldFrom && tick < _heldUntil ? _held : InputSnapshot{};
+}
+
+bool TickDriver::takeResume() {
+    const bool resume = _resumePending;
+    _resumePending = false;
+    return resume;
+}
+
+int64_t TickDriver::nextStep(const int64_t deadline) const {
+    if (_resumePending) return _tick + 1;
+    int64_t next = deadline;
+    for (const int64_t change : {_heldFrom, _heldUntil})
+        if (change > _tick) next = min(next, max(change - 1, _tick + 1));
+    return max(next, _tick + 1);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Clock.h"
+#include "Constants.h"
+#include "InputSnapshot.h"
+
+// Runs a game on the fixed tick grid from wall-clock time and timestamped key
+// events, stepping only the ticks where something happens. The console game
+// (Tetrominos), the server (RemoteSession) and `tetrominos-sim
+// --check-deadlines` all step their games through it.
+//
+// The game reads clock(), which shows tick() / tickRate() seconds. A key event
+// takes effect on the tick the wall time had reached when it was read, and
+// holds its action for kKeyHold from there, or longer while later events
+// repeat it. run() steps the controller's next deadline, and the tick the held
+// keys change on plus the tick before it (see GameController::nextDeadline());
+// the ticks in between would change nothing.
+class TickDriver {
+public:
+    static constexpr double kFrameInterval = 1.0 / 60;
+    static constexpr double kKeyHold = kFrameInterval; // how long a key press holds its action
+    static constexpr double kMaxCatchUp = 0.25; // seconds; a stall does not replay more than this
+
+    [[nodiscard]] const Clock &clock() const { return _clock; }
+    [[nodiscard]] int64_t tick() const { return _tick; }
+    [[nodiscard]] int tickRate() const { return _tickRate; }
+
+    // Puts the clock on `tick` at wall time `now`, with no keys held.
+    void reset(int tickRate, int64_t tick, double now);
+    // Makes `now` the wall time of the current tick, dropping the time spent
+    // outside the tick loop (menus, a too-small terminal).
+    void resync(double now);
+    // Moves the clock without stepping; replays step their recorded ticks themselves.
+    void setTick(int64_t tick);
+
+    // The wall time the clock reaches `tick` at, and the tick it has reached at `time`.
+    [[nodiscard]] double tickTime(int64_t tick) const;
+    [[nodiscard]] int64_t tickAt(double time) const;
+    // The tick reached at `now`. Wall time more than kMaxCatchUp past `next`,
+    // the first tick that had something to do, moves the grid instead of
+    // being replayed.
+    [[nodiscard]] int64_t catchUp(double now, int64_t next);
+
+    // The keys hold their actions from `from` for kKeyHold, or longer while
+    // later events repeat them.
+    void hold(const InputSnapshot &keys, int64_t from);
+    [[nodiscard]] InputSnapshot heldInput(int64_t tick) const;
+    [[nodiscard]] int64_t heldFrom() const { return _heldFrom; }
+    // Forgets the held keys, so the keys that paused or ended a game are not seen again after it.
+    void release() { _heldFrom = _heldUntil = _tick; }
+
+    // The next tick is stepped whatever the deadlines; a resumed game timer restarts there.
+    void resumeOnNextTick() { _resumePending = true; }
+    // True once, on the tick after resumeOnNextTick().
+    [[nodiscard]] bool takeResume();
+
+    // The tick to step next: the controller's `deadline`, or a change of the
+    // held keys before it.
+    [[nodiscard]] int64_t nextStep(int64_t deadline) const;
+
+    // Runs the ticks up to `current` with the key events read since the last
+    // call, in time order: each one is held from the tick it was read on, and
+    // the ticks before it still see the keys held until then. `deadline()`
+    // returns the controller's next deadline; `step(from, tick, input)` steps
+    // the game on `tick`, `from` being the first tick since the previous step,
+    // and returns false to stop (a menu, game over). With `stepCurrent`,
+    // `current` is stepped too, so the game shows the current tick; otherwise
+    // the clock stays on the last tick stepped. Returns false if a step stopped.
+    template <class Deadline, class Step>
+    bool play(const std::vector<KeyEvent> &events, int64_t current, bool stepCurrent, Deadline &&deadline,
+              Step &&step);
+    // Runs the ticks up to `until` without new keys, as play().
+    template <class Deadline, class Step>
+    bool run(int64_t until, bool stepUntil, Deadline &&deadline, Step &&step);
+
+private:
+    [[nodiscard]] static bool pressed(const InputSnapshot &keys);
+
+    ManualClock _clock;
+    int _tickRate{DEFAULT_TICK_RATE};
+    int64_t _tick{};
+    double _epoch{}; // wall time of tick 0, moved forward by pauses and stalls
+    InputSnapshot _held; // the keys of the last event, active on the ticks from _heldFrom until _heldUntil
+    int64_t _heldFrom{};
+    int64_t _heldUntil{};
+    bool _resumePending{};
+};
+
+template <class Deadline, class Step>
+bool TickDriver::play(const std::vector<KeyEvent> &events, const int64_t current, const bool stepCurrent,
+                      Deadline &&deadline, Step &&step) {
+    for (const KeyEvent &event : events) {
+        if (!pressed(event.keys)) continue;
+        const int64_t from = std::max(std::min(tickAt(event.time), current), _tick + 1);
+        // The tick before is stepped with the keys held until then, before hold() replaces them
+        if (!run(from - 1, true, deadline, step)) return false;
+        hold(event.keys, from);
+    }
+    return run(current, stepCurrent, deadline, step);
+}
+
+template <class Deadline, class Step>
+bool TickDriver::run(const int64_t until, const bool stepUntil, Deadline &&deadline, Step &&step) {
+    while (_tick < until) {
+        int64_t tick = nextStep(deadline());
+        if (tick > until) {
+            if (!stepUntil) return true;
+            tick = until;
+        }
+        const InputSnapshot input = heldInput(tick);
+        const int64_t from = _tick + 1;
+        setTick(tick);
+        if (!step(from, tick, input)) {
+            release();
+            return false;
+        }
+    }
+    return true;
+}
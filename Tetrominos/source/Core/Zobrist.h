@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Constants.h"
+#include "PieceData.h"
+
+// Zobrist keys for GameState::hash(), generated at compile time with
+// SplitMix64 so every build and platform hashes a state the same way.
+// A state's hash is the XOR of the keys of what it contains, so adding or
+// removing one thing is one XOR.
+template <size_t N>
+constexpr std::array<uint64_t, N> makeZobristKeys(uint64_t seed) {
+    std::array<uint64_t, N> keys{};
+    for (auto &key : keys) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        key = z ^ (z >> 31);
+    }
+    return keys;
+}
+
+inline constexpr auto kZobristCells = makeZobristKeys<BOARD_HEIGHT * BOARD_WIDTH>(0x5a0b1c2d3e4f5061ULL);
+inline constexpr auto kZobristHold = makeZobristKeys<PIECE_TYPE_COUNT>(0x17e4a2b9c0d3f586ULL);
+// Queue position i uses the piece key rotated left by i, so a pop shifts the
+// whole queue hash with one rotation (see PieceQueue::hash()).
+inline constexpr auto kZobristQueue = makeZobristKeys<PIECE_TYPE_COUNT>(0x2c6f9e8d7b5a4031ULL);
+
+[[nodiscard]] constexpr uint64_t zobristCell(const int row, const int column) {
+    return kZobristCells[static_cast<size_t>(row * BOARD_WIDTH + column)];
+}
+
+[[nodiscard]] constexpr uint64_t zobristHold(const PieceType type) {
+    return kZobristHold[static_cast<size_t>(type)];
+}
+
+[[nodiscard]] constexpr uint64_t rotateLeft(const uint64_t value, const int bits) {
+    return bits == 0 ? value : (value << bits) | (value >> (64 - bits));
+}
+
+[[nodiscard]] constexpr uint64_t zobristQueue(const size_t position, const PieceType type) {
+    return rotateLeft(kZobristQueue[static_cast<size_t>(type)], static_cast<int>(position));
+}
@@ -38,7 +38,8 @@ HelpDisplay::HelpDisplay() : _leftPanel(kLeftInterior), _rightPanel(kRightInteri
     _controlRows[4] = _leftPanel.addRow(makeRow("Rotate CW"));
     _controlRows[5] = _leftPanel.addRow(makeRow("Rotate CCW"));
     _controlRows[6] = _leftPanel.addRow(makeRow("Hold Piece"));
-    _controlRows[7] = _leftPanel.addRow(makeRow("Pause"));
+    _controlRows[7] = _leftPanel.addRow(makeRow("Undo Piece"));
+    _controlRows[8] = _leftPanel.addRow(makeRow("Pause"));
 
     // --- Right panel: About / Credits ---
     _rightPanel.addRow("ABOUT", Align::Center);
@@ -11,7 +11,7 @@
 
 using namespace std;
 
-static constexpr int kLeftInterior = 30;
+static constexpr int kLeftInterior = 35; // four 8-column variant tabs and their separators
 static constexpr int kRightInterior = 22;
 static constexpr int kLabelWidth = 9;
 static constexpr int kWindowWidth = 80;
@@ -23,8 +23,8 @@ static constexpr int kAvailableHeight = kWindowHeight - kAvailableTop;
 
 HighScoreDisplay::HighScoreDisplay() : _leftPanel(kLeftInterior), _rightPanel(kRightInterior) {
     // --- Left panel: tab row + 10 list rows ---
-    _tabRow = _leftPanel.addRow(
-        {Cell("Marathon", Align::Center), Cell("Sprint", Align::Center), Cell("Ultra", Align::Center)});
+    _tabRow = _leftPanel.addRow({Cell("Marathon", Align::Center), Cell("Sprint", Align::Center),
+                                 Cell("Ultra", Align::Center), Cell("Master", Align::Center)});
     _leftPanel.addSeparator();
     for (int i = 0; i < 10; i++)
         _listRows[static_cast<size_t>(i)] = _leftPanel.addRow("", Align::Left);
@@ -1,7 +1,6 @@
 #include "PieceDisplay.h"
 
 #include "PiecePreview.h"
-#include "Tetrimino.h"
 
 PieceDisplay::PieceDisplay(const size_t size) : _size(size), _panel(12) {
     if (_size == 0) _size = 1;
@@ -23,7 +22,7 @@ PieceDisplay::PieceDisplay(const size_t size) : _size(size), _panel(12) {
 
 PieceDisplay::~PieceDisplay() = default;
 
-void PieceDisplay::update(const std::vector<const Tetrimino *> &pieces) const {
+void PieceDisplay::update(const std::vector<PieceType> &pieces) const {
     for (size_t i = 0; i < _pieces.size(); i++) {
         if (i < pieces.size())
             _pieces[i]->setPiece(pieces[i]);
@@ -5,8 +5,8 @@
 #include <vector>
 
 #include "Panel.h"
+#include "PieceData.h"
 
-class Tetrimino;
 class PiecePreview;
 
 class PieceDisplay {
@@ -14,7 +14,7 @@ public:
     explicit PieceDisplay(size_t size = 1);
     ~PieceDisplay();
 
-    void update(const std::vector<const Tetrimino *> &pieces) const;
+    void update(const std::vector<PieceType> &pieces) const;
     void setPosition(int x, int y);
     void invalidate();
     void render();
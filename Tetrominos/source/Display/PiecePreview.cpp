@@ -26,15 +26,10 @@ void PiecePreview::setPiece(const PiecePreview *piecePreview) {
     markDirty();
 }
 
-void PiecePreview::setPiece(const Tetrimino *piece) {
-    if (piece == nullptr) {
-        clearPiece();
-        return;
-    }
-
-    _line1 = piece->getPreviewLine1();
-    _line2 = piece->getPreviewLine2();
-    _color = piece->getColor();
+void PiecePreview::setPiece(const PieceType type) {
+    _line1 = kPreviewLine1[static_cast<size_t>(type)];
+    _line2 = kPreviewLine2[static_cast<size_t>(type)];
+    _color = pieceColor(type);
     _hasPiece = true;
     markDirty();
 }
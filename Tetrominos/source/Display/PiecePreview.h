@@ -3,7 +3,7 @@
 #include <string>
 
 #include "Panel.h"
-#include "Tetrimino.h"
+#include "PieceData.h"
 
 class PiecePreview : public PanelElement {
 public:
@@ -11,7 +11,7 @@ public:
     void drawRow(int rowIndex, RowDrawContext &ctx) const override;
 
     void setPiece(const PiecePreview *piecePreview);
-    void setPiece(const Tetrimino *piece);
+    void setPiece(PieceType type);
     void clearPiece();
 
 private:
@@ -28,11 +28,7 @@ void PlayfieldElement::update(const GameState &state, const bool visible) {
     _state = &state;
     _visible = visible;
 
-    _ghostDropDistance = 0;
-    if (state.config.ghostEnabled && state.pieces.current != nullptr) {
-        while (state.pieces.current->simulateMove(Vector2i(_ghostDropDistance + 1, 0)))
-            _ghostDropDistance++;
-    }
+    _ghostDropDistance = state.config.ghostEnabled ? state.dropDistance() : 0;
 
     markDirty();
 }
@@ -84,7 +80,7 @@ void PlayfieldElement::drawRow(const int rowIndex, RowDrawContext &ctx) const {
         }
     }
 
-    const auto *tetrimino = _state->pieces.current;
+    const Tetrimino *tetrimino = _state->pieces.current ? &*_state->pieces.current : nullptr;
     for (int i = 0; i < BOARD_WIDTH; i++) {
         bool currentTetriminoHere = false;
         bool ghostHere = false;
@@ -93,13 +89,13 @@ void PlayfieldElement::drawRow(const int rowIndex, RowDrawContext &ctx) const {
             ghostHere = _ghostDropDistance > 0 && tetrimino->isMino(line - _ghostDropDistance, i);
         }
 
-        if (_visible && (_state->matrix[line][i] || currentTetriminoHere)) {
+        if (_visible && (_state->matrix.color(line, i) || currentTetriminoHere)) {
             if (currentTetriminoHere) {
                 ctx.setColor(tetrimino->getColor());
                 ctx.print("██");
             } else {
                 ctx.setColor(Color::BLACK);
-                ctx.setBackgroundColor(_state->matrix[line][i]);
+                ctx.setBackgroundColor(_state->matrix.color(line, i));
                 ctx.print("░░");
                 ctx.setBackgroundColor(Color::BLACK);
             }
@@ -136,12 +132,12 @@ void PlayfieldDisplay::update(const GameState &state, const bool visible) {
 
     _skylineColors.fill(0);
     if (visible) {
-        const auto *tetrimino = state.pieces.current;
+        const Tetrimino *tetrimino = state.pieces.current ? &*state.pieces.current : nullptr;
         for (int i = 0; i < BOARD_WIDTH; i++) {
             if (tetrimino != nullptr && tetrimino->isMino(BUFFER_END, i))
                 _skylineColors[i] = tetrimino->getColor();
-            else if (state.matrix[BUFFER_END][i])
-                _skylineColors[i] = state.matrix[BUFFER_END][i];
+            else if (state.matrix.color(BUFFER_END, i))
+                _skylineColors[i] = state.matrix.color(BUFFER_END, i);
         }
     }
 }
@@ -1,239 +1,77 @@
 #include "PieceData.h"
-#include "Color.h"
 
-#include <vector>
+// Compile-time checks on the piece tables. Nothing here is emitted; a typo in
+// PieceData.h fails the build instead of producing a piece that plays wrong.
 
-using namespace std;
+namespace {
 
-static PieceData buildI() {
-    PieceData data;
-    data.color = Color::LIGHTBLUE;
-    data.previewLine1 = "  ▄▄▄▄▄▄▄▄  ";
-    data.previewLine2 = "  ▀▀▀▀▀▀▀▀  ";
-    data.startingPosition = {19, 4};
-
-    const auto north = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {0, 2}};
-    const auto east = vector<Vector2i>{{0, 1}, {-1, 1}, {1, 1}, {2, 1}};
-    const auto south = vector<Vector2i>{{1, 0}, {1, -1}, {1, 1}, {1, 2}};
-    const auto west = vector<Vector2i>{{-1, 0}, {0, 0}, {1, 0}, {2, 0}};
-
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, -2}),
-                                           RotationPoint({0, 2}, {0, 1}), RotationPoint({-2, -1}, {1, -2}),
-                                           RotationPoint({1, 2}, {-2, 1})}};
-    const array<RotationPoint, 5> rotE = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 2}, {0, -1}),
-                                           RotationPoint({0, -1}, {0, 2}), RotationPoint({-1, 2}, {-2, -1}),
-                                           RotationPoint({2, -1}, {1, 2})}};
-    const array<RotationPoint, 5> rotS = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, 2}),
-                                           RotationPoint({0, -2}, {0, -1}), RotationPoint({2, 1}, {-1, 2}),
-                                           RotationPoint({-1, -2}, {2, -1})}};
-    const array<RotationPoint, 5> rotW = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -2}, {0, 1}),
-                                           RotationPoint({0, 1}, {0, -2}), RotationPoint({1, -2}, {2, 1}),
-                                           RotationPoint({-2, 1}, {-1, -2})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, east, rotE);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, south, rotS);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, west, rotW);
-
-    return data;
-}
-
-static PieceData buildJ() {
-    PieceData data;
-    data.color = Color::BLUE;
-    data.previewLine1 = "   ██       ";
-    data.previewLine2 = "   ██████   ";
-
-    const auto north = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {-1, -1}};
-    const auto east = vector<Vector2i>{{0, 0}, {-1, 0}, {1, 0}, {-1, 1}};
-    const auto south = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {1, 1}};
-    const auto west = vector<Vector2i>{{0, 0}, {1, 0}, {-1, 0}, {1, -1}};
-
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, -1}),
-                                           RotationPoint({-1, 1}, {-1, -1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, 1}, {2, -1})}};
-    const array<RotationPoint, 5> rotE = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, 1}),
-                                           RotationPoint({1, 1}, {1, 1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, 1}, {-2, 1})}};
-    const array<RotationPoint, 5> rotS = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, 1}),
-                                           RotationPoint({-1, -1}, {-1, 1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, -1}, {2, 1})}};
-    const array<RotationPoint, 5> rotW = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, -1}),
-                                           RotationPoint({1, -1}, {1, -1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, -1}, {-2, -1})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, east, rotE);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, south, rotS);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, west, rotW);
-
-    return data;
+constexpr bool sameOffset(const PieceOffset &a, const PieceOffset &b) {
+    return a.row == b.row && a.column == b.column;
 }
 
-static PieceData buildL() {
-    PieceData data;
-    data.color = Color::BROWN;
-    data.previewLine1 = "       ██   ";
-    data.previewLine2 = "   ██████   ";
-
-    const auto north = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {-1, 1}};
-    const auto east = vector<Vector2i>{{0, 0}, {-1, 0}, {1, 0}, {1, 1}};
-    const auto south = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {1, -1}};
-    const auto west = vector<Vector2i>{{0, 0}, {1, 0}, {-1, 0}, {-1, -1}};
-
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, -1}),
-                                           RotationPoint({-1, 1}, {-1, -1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, 1}, {5, -1})}};
-    const array<RotationPoint, 5> rotE = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, 1}),
-                                           RotationPoint({1, 1}, {1, 1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, 1}, {-2, 1})}};
-    const array<RotationPoint, 5> rotS = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, 1}),
-                                           RotationPoint({-1, -1}, {-1, 1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, -1}, {2, 1})}};
-    const array<RotationPoint, 5> rotW = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, -1}),
-                                           RotationPoint({1, -1}, {1, -1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, -1}, {-2, -1})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, east, rotE);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, south, rotS);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, west, rotW);
-
-    return data;
+// Every facing has four distinct minos that fit a Footprint (4 rows, columns
+// representable after the bias).
+constexpr bool minosAreWellFormed() {
+    for (const auto &facings : kPieceMinos) {
+        for (const auto &minos : facings) {
+            for (size_t i = 0; i < minos.size(); i++) {
+                if (minos[i].column + Footprint::kFootprintBias < 0) return false;
+                if (minos[i].column + Footprint::kFootprintBias > 4) return false;
+                if (minos[i].row < -1 || minos[i].row > 2) return false;
+                for (size_t j = i + 1; j < minos.size(); j++)
+                    if (sameOffset(minos[i], minos[j])) return false;
+            }
+        }
+    }
+    return true;
 }
 
-static PieceData buildO() {
-    PieceData data;
-    data.color = Color::YELLOW;
-    data.previewLine1 = "    ████    ";
-    data.previewLine2 = "    ████    ";
-
-    const auto north = vector<Vector2i>{{0, 0}, {-1, 0}, {-1, 1}, {0, 1}};
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, north, rotN);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, north, rotN);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, north, rotN);
-
-    return data;
+// Kick 0 is always the unshifted basic rotation.
+constexpr bool firstKickIsBasicRotation() {
+    for (const auto &facings : kPieceKicks) {
+        for (const auto &kicks : facings) {
+            if (!kicks[0].exists) return false;
+            if (!sameOffset(kicks[0].left, {0, 0}) || !sameOffset(kicks[0].right, {0, 0})) return false;
+        }
+    }
+    return true;
 }
 
-static PieceData buildS() {
-    PieceData data;
-    data.color = Color::GREEN;
-    data.previewLine1 = "     ████   ";
-    data.previewLine2 = "   ████     ";
-
-    const auto north = vector<Vector2i>{{0, 0}, {0, -1}, {-1, 0}, {-1, 1}};
-    const auto east = vector<Vector2i>{{0, 0}, {-1, 0}, {0, 1}, {1, 1}};
-    const auto south = vector<Vector2i>{{0, 0}, {0, 1}, {1, 0}, {1, -1}};
-    const auto west = vector<Vector2i>{{0, 0}, {1, 0}, {0, -1}, {-1, -1}};
-
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, -1}),
-                                           RotationPoint({-1, 1}, {-1, -1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, 1}, {2, -1})}};
-    const array<RotationPoint, 5> rotE = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, 1}),
-                                           RotationPoint({1, 1}, {1, 1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, 1}, {-2, 1})}};
-    const array<RotationPoint, 5> rotS = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, 1}),
-                                           RotationPoint({-1, -1}, {-1, 1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, -1}, {2, 1})}};
-    const array<RotationPoint, 5> rotW = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, -1}),
-                                           RotationPoint({1, -1}, {1, -1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, -1}, {-2, -1})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, east, rotE);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, south, rotS);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, west, rotW);
-
-    return data;
+constexpr bool footprintsCoverFourMinos() {
+    for (const auto &facings : kPieceFootprints) {
+        for (const auto &footprint : facings) {
+            int bits = 0;
+            for (int i = 0; i < footprint.rowCount; i++)
+                for (uint16_t mask = footprint.masks[static_cast<size_t>(i)]; mask != 0; mask &= mask - 1)
+                    bits++;
+            if (bits != MINO_COUNT) return false;
+        }
+    }
+    return true;
 }
 
-static PieceData buildT() {
-    PieceData data;
-    data.color = Color::MAGENTA;
-    data.previewLine1 = "     ██     ";
-    data.previewLine2 = "   ██████   ";
-
-    const auto north = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {-1, 0}};
-    const auto east = vector<Vector2i>{{0, 0}, {0, 1}, {-1, 0}, {1, 0}};
-    const auto south = vector<Vector2i>{{0, 0}, {0, -1}, {0, 1}, {1, 0}};
-    const auto west = vector<Vector2i>{{0, 0}, {0, -1}, {-1, 0}, {1, 0}};
-
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, -1}),
-                                           RotationPoint({-1, 1}, {-1, -1}), RotationPoint(),
-                                           RotationPoint({2, 1}, {2, -1})}};
-    const array<RotationPoint, 5> rotE = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, 1}),
-                                           RotationPoint({1, 1}, {1, 1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, 1}, {-2, 1})}};
-    const array<RotationPoint, 5> rotS = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, 1}),
-                                           RotationPoint(), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, -1}, {2, 1})}};
-    const array<RotationPoint, 5> rotW = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, -1}),
-                                           RotationPoint({1, -1}, {1, -1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, -1}, {-2, -1})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, east, rotE);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, south, rotS);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, west, rotW);
-
-    data.hasTSpin = true;
-    data.tSpinPositions[static_cast<int>(Rotation::North)] = TSpinPositions({-1, -1}, {-1, 1}, {1, -1}, {1, 1});
-    data.tSpinPositions[static_cast<int>(Rotation::East)] = TSpinPositions({-1, 1}, {1, 1}, {-1, -1}, {1, -1});
-    data.tSpinPositions[static_cast<int>(Rotation::South)] = TSpinPositions({1, 1}, {1, -1}, {-1, -1}, {-1, 1});
-    data.tSpinPositions[static_cast<int>(Rotation::West)] = TSpinPositions({1, -1}, {-1, -1}, {1, 1}, {-1, 1});
-
-    return data;
+constexpr bool isDiagonal(const PieceOffset &offset) {
+    return (offset.row == 1 || offset.row == -1) && (offset.column == 1 || offset.column == -1);
 }
 
-static PieceData buildZ() {
-    PieceData data;
-    data.color = Color::RED;
-    data.previewLine1 = "   ████     ";
-    data.previewLine2 = "     ████   ";
-
-    const auto north = vector<Vector2i>{{0, 0}, {0, 1}, {-1, 0}, {-1, -1}};
-    const auto east = vector<Vector2i>{{0, 0}, {1, 0}, {0, 1}, {-1, 1}};
-    const auto south = vector<Vector2i>{{0, 0}, {0, -1}, {1, 0}, {1, 1}};
-    const auto west = vector<Vector2i>{{0, 0}, {-1, 0}, {0, -1}, {1, -1}};
-
-    const array<RotationPoint, 5> rotN = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, -1}),
-                                           RotationPoint({-1, 1}, {-1, -1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, 1}, {2, -1})}};
-    const array<RotationPoint, 5> rotE = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, 1}, {0, 1}),
-                                           RotationPoint({1, 1}, {1, 1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, 1}, {-2, 1})}};
-    const array<RotationPoint, 5> rotS = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, 1}),
-                                           RotationPoint({-1, -1}, {-1, 1}), RotationPoint({2, 0}, {2, 0}),
-                                           RotationPoint({2, -1}, {2, 1})}};
-    const array<RotationPoint, 5> rotW = {{RotationPoint({0, 0}, {0, 0}), RotationPoint({0, -1}, {0, -1}),
-                                           RotationPoint({1, -1}, {1, -1}), RotationPoint({-2, 0}, {-2, 0}),
-                                           RotationPoint({-2, -1}, {-2, -1})}};
-
-    data.facings[static_cast<int>(Rotation::North)] = Facing(Rotation::North, north, rotN);
-    data.facings[static_cast<int>(Rotation::East)] = Facing(Rotation::East, east, rotE);
-    data.facings[static_cast<int>(Rotation::South)] = Facing(Rotation::South, south, rotS);
-    data.facings[static_cast<int>(Rotation::West)] = Facing(Rotation::West, west, rotW);
-
-    return data;
+// The four T-spin corners are the four distinct diagonals of the T center.
+constexpr bool tSpinCornersAreDiagonals() {
+    for (const auto &c : kTSpinCorners) {
+        const std::array<PieceOffset, 4> corners = {{c.A, c.B, c.C, c.D}};
+        for (size_t i = 0; i < corners.size(); i++) {
+            if (!isDiagonal(corners[i])) return false;
+            for (size_t j = i + 1; j < corners.size(); j++)
+                if (sameOffset(corners[i], corners[j])) return false;
+        }
+    }
+    return true;
 }
 
-static std::array<PieceData, 7> buildPieceTable() {
-    std::array<PieceData, 7> table;
-    table[static_cast<int>(PieceType::I)] = buildI();
-    table[static_cast<int>(PieceType::J)] = buildJ();
-    table[static_cast<int>(PieceType::L)] = buildL();
-    table[static_cast<int>(PieceType::O)] = buildO();
-    table[static_cast<int>(PieceType::S)] = buildS();
-    table[static_cast<int>(PieceType::T)] = buildT();
-    table[static_cast<int>(PieceType::Z)] = buildZ();
-    return table;
-}
+} // namespace
 
-const PieceData &getPieceData(PieceType type) {
-    static const auto table = buildPieceTable();
-    return table[static_cast<size_t>(type)];
-}
+static_assert(static_cast<int>(PieceType::Z) + 1 == PIECE_TYPE_COUNT);
+static_assert(static_cast<int>(Rotation::West) + 1 == ROTATION_COUNT);
+static_assert(minosAreWellFormed(), "piece minos must be distinct and fit a Footprint");
+static_assert(firstKickIsBasicRotation(), "kick 0 must be the unshifted rotation");
+static_assert(footprintsCoverFourMinos(), "footprints must hold exactly four minos");
+static_assert(tSpinCornersAreDiagonals(), "T-spin corners must be the four diagonals");
@@ -1,34 +1,228 @@
 #pragma once
 
-#include <string>
 #include <array>
+#include <cstdint>
+#include <string_view>
 
-#include "Facing.h"
+#include "Color.h"
+#include "GameMatrix.h"
 
-enum class PieceType { I, J, L, O, S, T, Z };
+enum class PieceType : uint8_t { I, J, L, O, S, T, Z };
 
-struct TSpinPositions {
-    TSpinPositions() = default;
+enum class Rotation : uint8_t { North = 0, East, South, West };
 
-    TSpinPositions(const Vector2i &a, const Vector2i &b, const Vector2i &c, const Vector2i &d)
-        : A(a), B(b), C(c), D(d) {}
+enum class Direction { Left = 0, Right };
 
-    Vector2i A;
-    Vector2i B;
-    Vector2i C;
-    Vector2i D;
-};
+inline constexpr int PIECE_TYPE_COUNT = 7;
+inline constexpr int ROTATION_COUNT = 4;
+inline constexpr int MINO_COUNT = 4;
+inline constexpr int KICK_COUNT = 5;
 
-struct PieceData {
-    int color;
-    std::string previewLine1;
-    std::string previewLine2;
-    std::array<Facing, 4> facings;
+// (row, column) offset relative to a piece position. Vector2i is not a literal
+// type, so the tables use this and convert at the point of use.
+struct PieceOffset {
+    int row;
+    int column;
+};
 
-    bool hasTSpin = false;
-    std::array<TSpinPositions, 4> tSpinPositions;
+// SRS wall kick data: each kick holds two translations (one per direction).
+// Kick 0 is basic rotation, kicks 1-4 are SRS wall kick offsets tested in order.
+struct Kick {
+    PieceOffset left;
+    PieceOffset right;
+    bool exists;
+};
 
-    Vector2i startingPosition = {19, 4};
+// T-spin corners relative to the T center: A and B in front, C and D behind.
+struct TSpinCorners {
+    PieceOffset A;
+    PieceOffset B;
+    PieceOffset C;
+    PieceOffset D;
 };
 
-const PieceData &getPieceData(PieceType type);
+using FacingMinos = std::array<PieceOffset, MINO_COUNT>;
+using FacingKicks = std::array<Kick, KICK_COUNT>;
+
+template <typename T>
+using PerRotation = std::array<T, ROTATION_COUNT>;
+
+template <typename T>
+using PerPiece = std::array<T, PIECE_TYPE_COUNT>;
+
+namespace piece_tables {
+
+constexpr Kick kick(const PieceOffset left, const PieceOffset right) {
+    return {left, right, true};
+}
+
+inline constexpr Kick kNoKick{{0, 0}, {0, 0}, false};
+
+// JLSZ share one kick table; T drops one kick on North and South.
+inline constexpr PerRotation<FacingKicks> kJLSZKicks = {{
+    {{kick({0, 0}, {0, 0}), kick({0, 1}, {0, -1}), kick({-1, 1}, {-1, -1}), kick({2, 0}, {2, 0}),
+      kick({2, 1}, {2, -1})}},
+    {{kick({0, 0}, {0, 0}), kick({0, 1}, {0, 1}), kick({1, 1}, {1, 1}), kick({-2, 0}, {-2, 0}),
+      kick({-2, 1}, {-2, 1})}},
+    {{kick({0, 0}, {0, 0}), kick({0, -1}, {0, 1}), kick({-1, -1}, {-1, 1}), kick({2, 0}, {2, 0}),
+      kick({2, -1}, {2, 1})}},
+    {{kick({0, 0}, {0, 0}), kick({0, -1}, {0, -1}), kick({1, -1}, {1, -1}), kick({-2, 0}, {-2, 0}),
+      kick({-2, -1}, {-2, -1})}},
+}};
+
+inline constexpr PerRotation<FacingKicks> kLKicks = {{
+    {{kick({0, 0}, {0, 0}), kick({0, 1}, {0, -1}), kick({-1, 1}, {-1, -1}), kick({2, 0}, {2, 0}),
+      kick({2, 1}, {5, -1})}},
+    kJLSZKicks[1],
+    kJLSZKicks[2],
+    kJLSZKicks[3],
+}};
+
+inline constexpr PerRotation<FacingKicks> kTKicks = {{
+    {{kick({0, 0}, {0, 0}), kick({0, 1}, {0, -1}), kick({-1, 1}, {-1, -1}), kNoKick, kick({2, 1}, {2, -1})}},
+    kJLSZKicks[1],
+    {{kick({0, 0}, {0, 0}), kick({0, -1}, {0, 1}), kNoKick, kick({2, 0}, {2, 0}), kick({2, -1}, {2, 1})}},
+    kJLSZKicks[3],
+}};
+
+inline constexpr PerRotation<FacingKicks> kIKicks = {{
+    {{kick({0, 0}, {0, 0}), kick({0, -1}, {0, -2}), kick({0, 2}, {0, 1}), kick({-2, -1}, {1, -2}),
+      kick({1, 2}, {-2, 1})}},
+    {{kick({0, 0}, {0, 0}), kick({0, 2}, {0, -1}), kick({0, -1}, {0, 2}), kick({-1, 2}, {-2, -1}),
+      kick({2, -1}, {1, 2})}},
+    {{kick({0, 0}, {0, 0}), kick({0, 1}, {0, 2}), kick({0, -2}, {0, -1}), kick({2, 1}, {-1, 2}),
+      kick({-1, -2}, {2, -1})}},
+    {{kick({0, 0}, {0, 0}), kick({0, -2}, {0, 1}), kick({0, 1}, {0, -2}), kick({1, -2}, {2, 1}),
+      kick({-2, 1}, {-1, -2})}},
+}};
+
+inline constexpr FacingKicks kOFacingKicks = {{kick({0, 0}, {0, 0}), kNoKick, kNoKick, kNoKick, kNoKick}};
+inline constexpr PerRotation<FacingKicks> kOKicks = {{kOFacingKicks, kOFacingKicks, kOFacingKicks, kOFacingKicks}};
+
+inline constexpr FacingMinos kONorth = {{{0, 0}, {-1, 0}, {-1, 1}, {0, 1}}};
+
+} // namespace piece_tables
+
+// Mino offsets, indexed [PieceType][Rotation][mino].
+inline constexpr PerPiece<PerRotation<FacingMinos>> kPieceMinos = {{
+    // I
+    {{{{{0, 0}, {0, -1}, {0, 1}, {0, 2}}},
+      {{{0, 1}, {-1, 1}, {1, 1}, {2, 1}}},
+      {{{1, 0}, {1, -1}, {1, 1}, {1, 2}}},
+      {{{-1, 0}, {0, 0}, {1, 0}, {2, 0}}}}},
+    // J
+    {{{{{0, 0}, {0, -1}, {0, 1}, {-1, -1}}},
+      {{{0, 0}, {-1, 0}, {1, 0}, {-1, 1}}},
+      {{{0, 0}, {0, -1}, {0, 1}, {1, 1}}},
+      {{{0, 0}, {1, 0}, {-1, 0}, {1, -1}}}}},
+    // L
+    {{{{{0, 0}, {0, -1}, {0, 1}, {-1, 1}}},
+      {{{0, 0}, {-1, 0}, {1, 0}, {1, 1}}},
+      {{{0, 0}, {0, -1}, {0, 1}, {1, -1}}},
+      {{{0, 0}, {1, 0}, {-1, 0}, {-1, -1}}}}},
+    // O
+    {{piece_tables::kONorth, piece_tables::kONorth, piece_tables::kONorth, piece_tables::kONorth}},
+    // S
+    {{{{{0, 0}, {0, -1}, {-1, 0}, {-1, 1}}},
+      {{{0, 0}, {-1, 0}, {0, 1}, {1, 1}}},
+      {{{0, 0}, {0, 1}, {1, 0}, {1, -1}}},
+      {{{0, 0}, {1, 0}, {0, -1}, {-1, -1}}}}},
+    // T
+    {{{{{0, 0}, {0, -1}, {0, 1}, {-1, 0}}},
+      {{{0, 0}, {0, 1}, {-1, 0}, {1, 0}}},
+      {{{0, 0}, {0, -1}, {0, 1}, {1, 0}}},
+      {{{0, 0}, {0, -1}, {-1, 0}, {1, 0}}}}},
+    // Z
+    {{{{{0, 0}, {0, 1}, {-1, 0}, {-1, -1}}},
+      {{{0, 0}, {1, 0}, {0, 1}, {-1, 1}}},
+      {{{0, 0}, {0, -1}, {1, 0}, {1, 1}}},
+      {{{0, 0}, {-1, 0}, {0, -1}, {1, -1}}}}},
+}};
+
+// SRS kick tests, indexed [PieceType][Rotation][kick].
+inline constexpr PerPiece<PerRotation<FacingKicks>> kPieceKicks = {{
+    piece_tables::kIKicks,
+    piece_tables::kJLSZKicks,
+    piece_tables::kLKicks,
+    piece_tables::kOKicks,
+    piece_tables::kJLSZKicks,
+    piece_tables::kTKicks,
+    piece_tables::kJLSZKicks,
+}};
+
+// T-spin corners, indexed [Rotation]; only the T piece has them.
+inline constexpr PerRotation<TSpinCorners> kTSpinCorners = {{
+    {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}},
+    {{-1, 1}, {1, 1}, {-1, -1}, {1, -1}},
+    {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}},
+    {{1, -1}, {-1, -1}, {1, 1}, {-1, 1}},
+}};
+
+inline constexpr PerPiece<int> kPieceColors = {
+    {Color::LIGHTBLUE, Color::BLUE, Color::BROWN, Color::YELLOW, Color::GREEN, Color::MAGENTA, Color::RED}};
+
+inline constexpr PerPiece<std::string_view> kPreviewLine1 = {
+    {"  ▄▄▄▄▄▄▄▄  ", "   ██       ", "       ██   ", "    ████    ", "     ████   ", "     ██     ", "   ████     "}};
+
+inline constexpr PerPiece<std::string_view> kPreviewLine2 = {
+    {"  ▀▀▀▀▀▀▀▀  ", "   ██████   ", "   ██████   ", "    ████    ", "   ████     ", "   ██████   ", "     ████   "}};
+
+inline constexpr PieceOffset kStartingPosition = {19, 4};
+
+constexpr Footprint makeFootprint(const FacingMinos &minos) {
+    int top = minos[0].row;
+    int bottom = minos[0].row;
+    for (const auto &mino : minos) {
+        top = mino.row < top ? mino.row : top;
+        bottom = mino.row > bottom ? mino.row : bottom;
+    }
+
+    Footprint footprint{};
+    footprint.topRow = top;
+    footprint.rowCount = bottom - top + 1;
+    for (auto &lowest : footprint.bottoms) lowest = Footprint::kNoMino;
+    for (const auto &mino : minos) {
+        auto &mask = footprint.masks[static_cast<size_t>(mino.row - top)];
+        mask = static_cast<uint16_t>(mask | (1u << (mino.column + Footprint::kFootprintBias)));
+        auto &lowest = footprint.bottoms[static_cast<size_t>(mino.column + Footprint::kFootprintBias)];
+        if (mino.row > lowest) lowest = static_cast<int8_t>(mino.row);
+    }
+    return footprint;
+}
+
+constexpr PerPiece<PerRotation<Footprint>> makeFootprints() {
+    PerPiece<PerRotation<Footprint>> footprints{};
+    for (size_t type = 0; type < PIECE_TYPE_COUNT; type++)
+        for (size_t rotation = 0; rotation < ROTATION_COUNT; rotation++)
+            footprints[type][rotation] = makeFootprint(kPieceMinos[type][rotation]);
+    return footprints;
+}
+
+// Collision masks derived from kPieceMinos, indexed [PieceType][Rotation].
+inline constexpr PerPiece<PerRotation<Footprint>> kPieceFootprints = makeFootprints();
+
+// The facing after one rotation step in the given direction.
+[[nodiscard]] constexpr Rotation rotated(const Rotation rotation, const Direction direction) {
+    const int step = direction == Direction::Right ? 1 : ROTATION_COUNT - 1;
+    return static_cast<Rotation>((static_cast<int>(rotation) + step) % ROTATION_COUNT);
+}
+
+[[nodiscard]] constexpr const FacingMinos &pieceMinos(const PieceType type, const Rotation rotation) {
+    return kPieceMinos[static_cast<size_t>(type)][static_cast<size_t>(rotation)];
+}
+
+[[nodiscard]] constexpr const FacingKicks &pieceKicks(const PieceType type, const Rotation rotation) {
+    return kPieceKicks[static_cast<size_t>(type)][static_cast<size_t>(rotation)];
+}
+
+[[nodiscard]] constexpr const Footprint &pieceFootprint(const PieceType type, const Rotation rotation) {
+    return kPieceFootprints[static_cast<size_t>(type)][static_cast<size_t>(rotation)];
+}
+
+[[nodiscard]] constexpr int pieceColor(const PieceType type) {
+    return kPieceColors[static_cast<size_t>(type)];
+}
+
+[[nodiscard]] constexpr bool pieceHasTSpin(const PieceType type) {
+    return type == PieceType::T;
+}
@@ -1,40 +1,42 @@
 #include "Tetrimino.h"
 
-#include "Constants.h"
-#include "Platform.h"
+#include <type_traits>
 
 using namespace std;
 
+static_assert(is_trivially_copyable_v<Tetrimino>);
+static_assert(sizeof(Tetrimino) <= 8);
 
-Tetrimino::Tetrimino(const PieceType type, GameMatrix &matrix) : _matrix(matrix) {
-    const PieceData &data = getPieceData(type);
-    _color = data.color;
-    _startingPosition = data.startingPosition;
-    _previewLine1 = data.previewLine1;
-    _previewLine2 = data.previewLine2;
-    _facings = data.facings;
-    _hasTSpin = data.hasTSpin;
-    _tSpinPositions = data.tSpinPositions;
+static Vector2i toVector(const PieceOffset &offset) {
+    return {offset.row, offset.column};
+}
 
-    _currentRotation = Rotation::North;
-    _lastRotationPoint = -1;
+Tetrimino::Tetrimino(const PieceType type) : _type(type) {
 }
 
-Tetrimino::~Tetrimino() = default;
+Tetrimino::Tetrimino(const PieceType type, const Rotation rotation, const Vector2i &position,
+                     const int lastRotationPoint)
+    : _type(type), _rotation(rotation), _lastRotationPoint(static_cast<int8_t>(lastRotationPoint)) {
+    place(position);
+}
 
-bool Tetrimino::setPosition(const Vector2i &position) {
-    if (checkPositionValidity(position, _currentRotation)) {
-        _currentPosition = position;
+void Tetrimino::place(const Vector2i &position) {
+    _row = static_cast<int8_t>(position.row);
+    _column = static_cast<int8_t>(position.column);
+}
+
+bool Tetrimino::setPosition(const GameMatrix &matrix, const Vector2i &position) {
+    if (checkPositionValidity(matrix, position, _rotation)) {
+        place(position);
         return true;
     }
 
     return false;
 }
 
-bool Tetrimino::move(const Vector2i &distance) {
-    if (const Vector2i newPosition = _currentPosition + distance;
-        checkPositionValidity(newPosition, _currentRotation)) {
-        _currentPosition = newPosition;
+bool Tetrimino::move(const GameMatrix &matrix, const Vector2i &distance) {
+    if (const Vector2i newPosition = getPosition() + distance; checkPositionValidity(matrix, newPosition, _rotation)) {
+        place(newPosition);
         _lastRotationPoint = -1;
         return true;
     }
@@ -42,34 +44,28 @@ bool Tetrimino::move(const Vector2i &distance) {
     return false;
 }
 
-bool Tetrimino::simulateMove(const Vector2i &distance) const {
-    const Vector2i newPosition = _currentPosition + distance;
-    return checkPositionValidity(newPosition, _currentRotation);
+bool Tetrimino::simulateMove(const GameMatrix &matrix, const Vector2i &distance) const {
+    const Vector2i newPosition = getPosition() + distance;
+    return checkPositionValidity(matrix, newPosition, _rotation);
 }
 
-bool Tetrimino::rotate(const Direction direction) {
-    Rotation newRotation = _currentRotation;
-    if (direction == Direction::Left) {
-        if (newRotation == Rotation::North)
-            newRotation = Rotation::West;
-        else
-            newRotation = static_cast<Rotation>(static_cast<int>(newRotation) - 1);
-    } else if (direction == Direction::Right) {
-        if (newRotation == Rotation::West)
-            newRotation = Rotation::North;
-        else
-            newRotation = static_cast<Rotation>(static_cast<int>(newRotation) + 1);
-    }
+int Tetrimino::dropDistance(const GameMatrix &matrix) const {
+    return matrix.dropDistance(pieceFootprint(_type, _rotation), _row, _column);
+}
 
-    Facing const &currentFacing = _facings[static_cast<int>(_currentRotation)];
-    for (int i = 0; i < 5; i++) {
-        RotationPoint const &rotationPoint = currentFacing.getRotationPoint(i);
-        if (!rotationPoint.exist()) continue;
-        if (const Vector2i newPosition = _currentPosition + rotationPoint.getTranslation(direction);
-            checkPositionValidity(newPosition, newRotation)) {
-            _currentPosition = newPosition;
-            _currentRotation = newRotation;
-            _lastRotationPoint = i + 1;
+bool Tetrimino::rotate(const GameMatrix &matrix, const Direction direction) {
+    const Rotation newRotation = rotated(_rotation, direction);
+
+    const FacingKicks &kicks = pieceKicks(_type, _rotation);
+    for (int i = 0; i < KICK_COUNT; i++) {
+        const Kick &kick = kicks[static_cast<size_t>(i)];
+        if (!kick.exists) continue;
+        const PieceOffset &translation = direction == Direction::Left ? kick.left : kick.right;
+        if (const Vector2i newPosition = getPosition() + toVector(translation);
+            checkPositionValidity(matrix, newPosition, newRotation)) {
+            place(newPosition);
+            _rotation = newRotation;
+            _lastRotationPoint = static_cast<int8_t>(i + 1);
             return true;
         }
     }
@@ -77,63 +73,45 @@ bool Tetrimino::rotate(const Direction direction) {
     return false;
 }
 
-bool Tetrimino::lock() {
-    const Facing &facing = _facings[static_cast<int>(_currentRotation)];
-    const int minoCount = facing.getMinoCount();
+bool Tetrimino::lock(GameMatrix &matrix) {
+    const int color = getColor();
 
     bool gameOver = true;
-    for (int i = 0; i < minoCount; i++) {
-        const Vector2i minoPos = _currentPosition + facing.getMino(i);
-        _matrix[minoPos.row][minoPos.column] = _color;
+    for (const auto &mino : pieceMinos(_type, _rotation)) {
+        const Vector2i minoPos = getPosition() + toVector(mino);
+        matrix.set(minoPos.row, minoPos.column, color);
         if (minoPos.row >= MATRIX_START) gameOver = false;
     }
 
-    _currentRotation = Rotation::North;
+    _rotation = Rotation::North;
     _lastRotationPoint = -1;
 
     return !gameOver;
 }
 
 void Tetrimino::resetRotation() {
-    _currentRotation = Rotation::North;
+    _rotation = Rotation::North;
     _lastRotationPoint = -1;
 }
 
 bool Tetrimino::isMino(const int row, const int column) const {
-    const auto position = Vector2i(row, column);
-    Facing const &currentFacing = _facings[static_cast<int>(_currentRotation)];
-    const int minoCount = currentFacing.getMinoCount();
-    const Vector2i relativePos = position - _currentPosition;
-
-    bool result = false;
-    for (int i = 0; i < minoCount; i++) {
-        if (currentFacing.getMino(i) == relativePos) {
-            result = true;
-            break;
-        }
-    }
-
-    return result;
-}
+    const int relativeRow = row - _row;
+    const int relativeColumn = column - _column;
 
-int Tetrimino::getMino(const int row, const int column) const {
-    if (row >= 0 && row < BOARD_HEIGHT && column >= 0 && column < BOARD_WIDTH) return _matrix[row][column];
+    for (const auto &mino : pieceMinos(_type, _rotation)) {
+        if (mino.row == relativeRow && mino.column == relativeColumn) return true;
+    }
 
-    return 1;
+    return false;
 }
 
-int Tetrimino::getMino(const Vector2i &position) const {
-    return getMino(position.row, position.column);
+bool Tetrimino::isOccupied(const GameMatrix &matrix, const PieceOffset &corner) const {
+    return matrix.isOccupied(_row + corner.row, _column + corner.column);
 }
 
-bool Tetrimino::checkPositionValidity(const Vector2i &position, const Rotation rotation) const {
-    const Facing &facing = _facings[static_cast<int>(rotation)];
-    const int minoCount = facing.getMinoCount();
-    bool valid = true;
-    for (int i = 0; i < minoCount; i++) {
-        if (getMino(position + facing.getMino(i)) > 0) valid = false;
-    }
-    return valid;
+bool Tetrimino::checkPositionValidity(const GameMatrix &matrix, const Vector2i &position,
+                                      const Rotation rotation) const {
+    return matrix.fits(pieceFootprint(_type, rotation), position.row, position.column);
 }
 
 // T-spin detection uses the 3-corner rule:
@@ -145,33 +123,33 @@ bool Tetrimino::checkPositionValidity(const Vector2i &position, const Rotation r
 // Mini T-spin: C and D both occupied, plus at least one of A or B,
 //              AND a wall kick was used (rotation point >= 2).
 // Special case: the 5th SRS kick (TST kick) always promotes a mini to full.
-bool Tetrimino::checkTSpin() const {
-    if (!_hasTSpin) return false;
+bool Tetrimino::checkTSpin(const GameMatrix &matrix) const {
+    if (!canTSpin()) return false;
 
-    if (getLastRotationPoint() < 0) return false;
+    if (_lastRotationPoint < 0) return false;
 
-    TSpinPositions const &tspinPos = _tSpinPositions[static_cast<int>(getCurrentRotation())];
+    const TSpinCorners &corners = kTSpinCorners[static_cast<size_t>(_rotation)];
 
-    if (const Vector2i position = getPosition(); getMino(position + tspinPos.A) && getMino(position + tspinPos.B) &&
-                                                 (getMino(position + tspinPos.C) || getMino(position + tspinPos.D)))
+    if (isOccupied(matrix, corners.A) && isOccupied(matrix, corners.B) &&
+        (isOccupied(matrix, corners.C) || isOccupied(matrix, corners.D)))
         return true;
 
     // TST kick (point 5) promotes mini to full
-    if (checkMiniTSpin()) return getLastRotationPoint() == 5;
+    if (checkMiniTSpin(matrix)) return _lastRotationPoint == 5;
 
     return false;
 }
 
-bool Tetrimino::checkMiniTSpin() const {
-    if (!_hasTSpin) return false;
+bool Tetrimino::checkMiniTSpin(const GameMatrix &matrix) const {
+    if (!canTSpin()) return false;
 
     // Must be a wall kick (point >= 2); basic rotation (point 1) doesn't qualify
-    if (getLastRotationPoint() <= 1) return false;
+    if (_lastRotationPoint <= 1) return false;
 
-    TSpinPositions const &tspinPos = _tSpinPositions[static_cast<int>(getCurrentRotation())];
+    const TSpinCorners &corners = kTSpinCorners[static_cast<size_t>(_rotation)];
 
-    if (const Vector2i position = getPosition(); getMino(position + tspinPos.C) && getMino(position + tspinPos.D) &&
-                                                 (getMino(position + tspinPos.A) || getMino(position + tspinPos.B)))
+    if (isOccupied(matrix, corners.C) && isOccupied(matrix, corners.D) &&
+        (isOccupied(matrix, corners.A) || isOccupied(matrix, corners.B)))
         return true;
 
     return false;
@@ -1,56 +1,55 @@
 #pragma once
 
-#include <string>
-#include <array>
+#include <cstdint>
+#include <string_view>
 
 #include "Constants.h"
+#include "GameMatrix.h"
 #include "PieceData.h"
+#include "Vector2i.h"
 
+// A live piece: type, rotation and position. Shape, kicks and colors come from
+// the constexpr tables in PieceData.h, so a Tetrimino is a few bytes and
+// trivially copyable. Collision methods take the matrix they test against.
 class Tetrimino {
 public:
-    Tetrimino(PieceType type, GameMatrix &matrix);
-    ~Tetrimino();
-
-    [[nodiscard]] bool setPosition(const Vector2i &position);
-    [[nodiscard]] bool move(const Vector2i &distance);
-    [[nodiscard]] bool simulateMove(const Vector2i &distance) const;
-    [[nodiscard]] bool rotate(Direction direction);
-    [[nodiscard]] bool lock();
+    Tetrimino() = default;
+    explicit Tetrimino(PieceType type);
+    // A piece at a known pose (e.g. from the move generator); not collision-checked.
+    Tetrimino(PieceType type, Rotation rotation, const Vector2i &position, int lastRotationPoint = -1);
+
+    [[nodiscard]] bool setPosition(const GameMatrix &matrix, const Vector2i &position);
+    [[nodiscard]] bool move(const GameMatrix &matrix, const Vector2i &distance);
+    [[nodiscard]] bool simulateMove(const GameMatrix &matrix, const Vector2i &distance) const;
+    // Rows the piece can fall from its position; 0 when it rests on the stack.
+    [[nodiscard]] int dropDistance(const GameMatrix &matrix) const;
+    [[nodiscard]] bool rotate(const GameMatrix &matrix, Direction direction);
+    [[nodiscard]] bool lock(GameMatrix &matrix);
     void resetRotation();
 
     [[nodiscard]] bool isMino(int row, int column) const;
-    [[nodiscard]] Vector2i const &getPosition() const { return _currentPosition; }
-
-    [[nodiscard]] int getColor() const { return _color; }
-    [[nodiscard]] const std::string &getPreviewLine1() const { return _previewLine1; }
-    [[nodiscard]] const std::string &getPreviewLine2() const { return _previewLine2; }
-    [[nodiscard]] Vector2i getStartingPosition() const { return _startingPosition; }
-    [[nodiscard]] bool canTSpin() const { return _hasTSpin; }
-    bool checkTSpin() const;
-    bool checkMiniTSpin() const;
-
-private:
-    [[nodiscard]] int getMino(int row, int column) const;
-    [[nodiscard]] int getMino(const Vector2i &position) const;
-    [[nodiscard]] bool checkPositionValidity(const Vector2i &position, Rotation rotation) const;
-
+    [[nodiscard]] Vector2i getPosition() const { return {_row, _column}; }
+    [[nodiscard]] Rotation getRotation() const { return _rotation; }
     [[nodiscard]] int getLastRotationPoint() const { return _lastRotationPoint; }
-    [[nodiscard]] Rotation getCurrentRotation() const { return _currentRotation; }
 
-    GameMatrix &_matrix;
+    [[nodiscard]] PieceType getType() const { return _type; }
+    [[nodiscard]] int getColor() const { return pieceColor(_type); }
+    [[nodiscard]] std::string_view getPreviewLine1() const { return kPreviewLine1[static_cast<size_t>(_type)]; }
+    [[nodiscard]] std::string_view getPreviewLine2() const { return kPreviewLine2[static_cast<size_t>(_type)]; }
+    [[nodiscard]] Vector2i getStartingPosition() const { return {kStartingPosition.row, kStartingPosition.column}; }
+    [[nodiscard]] bool canTSpin() const { return pieceHasTSpin(_type); }
+    [[nodiscard]] bool checkTSpin(const GameMatrix &matrix) const;
+    [[nodiscard]] bool checkMiniTSpin(const GameMatrix &matrix) const;
 
-    int _color;
-    Vector2i _startingPosition;
-    std::array<Facing, 4> _facings;
-    int _lastRotationPoint;
-
-    std::string _previewLine1;
-    std::string _previewLine2;
-
-    Rotation _currentRotation;
-    Vector2i _currentPosition;
-
-    // T-spin data (only meaningful for T piece)
-    bool _hasTSpin;
-    std::array<TSpinPositions, 4> _tSpinPositions;
+private:
+    [[nodiscard]] bool isOccupied(const GameMatrix &matrix, const PieceOffset &corner) const;
+    [[nodiscard]] bool checkPositionValidity(const GameMatrix &matrix, const Vector2i &position,
+                                             Rotation rotation) const;
+    void place(const Vector2i &position);
+
+    PieceType _type{PieceType::I};
+    Rotation _rotation{Rotation::North};
+    int8_t _lastRotationPoint{-1};
+    int8_t _row{};
+    int8_t _column{};
 };
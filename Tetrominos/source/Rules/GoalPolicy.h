@@ -12,16 +12,16 @@ public:
 
 class VariableGoal final : public GoalPolicy {
 public:
-    [[nodiscard]] int goalValue(int level) const override;
-    [[nodiscard]] int startingGoalValue(int level) const override;
-    [[nodiscard]] bool useAwardedLines() const override;
+    [[nodiscard]] int goalValue(const int level) const override { return 5 * level; }
+    [[nodiscard]] int startingGoalValue(const int level) const override { return 5 * level; }
+    [[nodiscard]] bool useAwardedLines() const override { return true; }
 };
 
 class FixedGoal final : public GoalPolicy {
 public:
-    [[nodiscard]] int goalValue(int level) const override;
-    [[nodiscard]] int startingGoalValue(int level) const override;
-    [[nodiscard]] bool useAwardedLines() const override;
+    [[nodiscard]] int goalValue(int) const override { return 10; }
+    [[nodiscard]] int startingGoalValue(const int level) const override { return 10 * level; }
+    [[nodiscard]] bool useAwardedLines() const override { return false; }
 };
 
 std::unique_ptr<GoalPolicy> makeDefaultGoalPolicy();
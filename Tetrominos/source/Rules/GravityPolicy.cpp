@@ -5,10 +5,15 @@
 
 #include "Constants.h"
 
+// Guideline curve: (0.8 - (level - 1) * 0.007) ^ (level - 1) seconds per row.
+static double guidelineFallSeconds(const int level) {
+    return std::pow(0.8 - (level - 1) * 0.007, level - 1);
+}
+
 double GuidelineGravity::fallInterval(const int level, const DropType dropType) const {
     switch (dropType) {
-        case DropType::Normal: return GRAVITY_EQUATION(level);
-        case DropType::Soft: return GRAVITY_EQUATION(level) / kSoftDropFactor;
+        case DropType::Normal: return guidelineFallSeconds(level);
+        case DropType::Soft: return guidelineFallSeconds(level) / kSoftDropFactor;
         case DropType::Hard: return kHardDropSpeed;
         default: return 1.0;
     }
@@ -2,12 +2,12 @@
 
 #include <memory>
 
-#define GRAVITY_EQUATION(level) pow((0.8 - ((level - 1) * 0.007)), level - 1)
-
 enum class DropType;
 static constexpr double kSoftDropFactor = 20.0;
 static constexpr double kHardDropSpeed = 0.0001;
 
+// Seconds per row at a level. Only read when TickTimings builds its per-level
+// table, never per tick.
 class GravityPolicy {
 public:
     virtual ~GravityPolicy() = default;
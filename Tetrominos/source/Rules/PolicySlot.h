@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Holds one rule policy of a BasicGameController. An abstract policy type is
+// kept behind a unique_ptr and can be swapped at runtime (the interactive
+// game). A concrete, final policy is kept by value, so every call on it is
+// direct and can be inlined (the headless simulator).
+template <class Policy, bool = std::is_abstract_v<Policy>>
+class PolicySlot {
+public:
+    static constexpr bool kConfigurable = true;
+
+    template <class Factory>
+    explicit PolicySlot(Factory factory) : _policy(factory()) {}
+
+    void reset(std::unique_ptr<Policy> policy) { _policy = std::move(policy); }
+    [[nodiscard]] Policy *get() const { return _policy.get(); }
+    Policy *operator->() const { return _policy.get(); }
+    Policy &operator*() const { return *_policy; }
+
+private:
+    std::unique_ptr<Policy> _policy;
+};
+
+template <class Policy>
+class PolicySlot<Policy, false> {
+public:
+    static constexpr bool kConfigurable = false;
+
+    // The factory is never called: the policy type alone decides the rules.
+    template <class Factory>
+    explicit PolicySlot(Factory) {}
+
+    [[nodiscard]] Policy *get() { return &_policy; }
+    [[nodiscard]] const Policy *get() const { return &_policy; }
+    Policy *operator->() { return &_policy; }
+    const Policy *operator->() const { return &_policy; }
+    Policy &operator*() { return _policy; }
+    const Policy &operator*() const { return _policy; }
+
+private:
+    Policy _policy;
+};
@@ -0,0 +1,113 @@
+#include "Randomizer.h"
+
+#include <algorithm>
+
+using namespace std;
+
+static PieceType randomPiece(Rng &rng) {
+    return static_cast<PieceType>(rng.getInteger(0, PIECE_TYPE_COUNT - 1));
+}
+
+// Fisher-Yates over the whole bag
+template <size_t N>
+static void shuffleBag(array<PieceType, N> &bag, Rng &rng) {
+    for (size_t i = N - 1; i > 0; i--) {
+        const auto j = static_cast<size_t>(rng.getInteger(0, static_cast<int>(i)));
+        if (i != j) swap(bag[i], bag[j]);
+    }
+}
+
+PieceType SevenBagRandomizer::next(Rng &rng) {
+    if (_index >= _bag.size()) {
+        for (size_t i = 0; i < _bag.size(); i++)
+            _bag[i] = static_cast<PieceType>(i);
+        shuffleBag(_bag, rng);
+        _index = 0;
+    }
+    return _bag[_index++];
+}
+
+// A bag is saved with its position; the pieces past the bag size stay unused.
+template <size_t N>
+static RandomizerState saveBag(const array<PieceType, N> &bag, const size_t index) {
+    RandomizerState state;
+    copy(bag.begin(), bag.end(), state.pieces.begin());
+    state.index = static_cast<uint8_t>(index);
+    return state;
+}
+
+template <size_t N>
+static void restoreBag(array<PieceType, N> &bag, size_t &index, const RandomizerState &state) {
+    copy_n(state.pieces.begin(), N, bag.begin());
+    index = state.index;
+}
+
+RandomizerState SevenBagRandomizer::save() const {
+    return saveBag(_bag, _index);
+}
+
+void SevenBagRandomizer::restore(const RandomizerState &state) {
+    restoreBag(_bag, _index, state);
+}
+
+PieceType FourteenBagRandomizer::next(Rng &rng) {
+    if (_index >= _bag.size()) {
+        for (size_t i = 0; i < _bag.size(); i++)
+            _bag[i] = static_cast<PieceType>(i % PIECE_TYPE_COUNT);
+        shuffleBag(_bag, rng);
+        _index = 0;
+    }
+    return _bag[_index++];
+}
+
+RandomizerState FourteenBagRandomizer::save() const {
+    return saveBag(_bag, _index);
+}
+
+void FourteenBagRandomizer::restore(const RandomizerState &state) {
+    restoreBag(_bag, _index, state);
+}
+
+PieceType MemorylessRandomizer::next(Rng &rng) {
+    return randomPiece(rng);
+}
+
+PieceType TgmHistoryRandomizer::next(Rng &rng) {
+    PieceType piece;
+    if (_first) {
+        static constexpr array<PieceType, 4> kFirstPieces = {PieceType::I, PieceType::J, PieceType::L, PieceType::T};
+        piece = kFirstPieces[static_cast<size_t>(rng.getInteger(0, 3))];
+        _first = false;
+    } else {
+        piece = randomPiece(rng);
+        for (int roll = 1; roll < kRolls && find(_history.begin(), _history.end(), piece) != _history.end(); roll++)
+            piece = randomPiece(rng);
+    }
+
+    rotate(_history.begin(), _history.begin() + 1, _history.end());
+    _history.back() = piece;
+    return piece;
+}
+
+// index holds the first-piece flag
+RandomizerState TgmHistoryRandomizer::save() const {
+    RandomizerState state;
+    copy(_history.begin(), _history.end(), state.pieces.begin());
+    state.index = _first ? 1 : 0;
+    return state;
+}
+
+void TgmHistoryRandomizer::restore(const RandomizerState &state) {
+    copy_n(state.pieces.begin(), _history.size(), _history.begin());
+    _first = state.index != 0;
+}
+
+unique_ptr<Randomizer> makeRandomizer(const RandomizerType type) {
+    switch (type) {
+        case RandomizerType::SevenBag: return make_unique<SevenBagRandomizer>();
+        case RandomizerType::FourteenBag: return make_unique<FourteenBagRandomizer>();
+        case RandomizerType::Memoryless: return make_unique<MemorylessRandomizer>();
+        case RandomizerType::TgmHistory: return make_unique<TgmHistoryRandomizer>();
+    }
+    return make_unique<SevenBagRandomizer>();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "Constants.h"
+#include "PieceData.h"
+#include "Rng.h"
+
+// A randomizer's internal state as plain data, so a game snapshot can save and
+// restore it without allocating. Each randomizer decides what the fields mean.
+struct RandomizerState {
+    std::array<PieceType, 2 * PIECE_TYPE_COUNT> pieces{}; // bag or history
+    uint8_t index{};
+};
+
+// Source of the piece sequence. PieceQueue pulls from it one piece at a time
+// to keep its lookahead buffer full; all randomness comes from the game's Rng.
+class Randomizer {
+public:
+    virtual ~Randomizer() = default;
+    [[nodiscard]] virtual PieceType next(Rng &rng) = 0;
+    // Stateless randomizers keep the defaults.
+    [[nodiscard]] virtual RandomizerState save() const { return {}; }
+    virtual void restore(const RandomizerState & /*state*/) {}
+};
+
+// Guideline 7-bag: every piece once per shuffled bag of 7.
+class SevenBagRandomizer final : public Randomizer {
+public:
+    [[nodiscard]] PieceType next(Rng &rng) override;
+    [[nodiscard]] RandomizerState save() const override;
+    void restore(const RandomizerState &state) override;
+
+private:
+    std::array<PieceType, PIECE_TYPE_COUNT> _bag{};
+    size_t _index{PIECE_TYPE_COUNT};
+};
+
+// Two copies of every piece per shuffled bag of 14; allows short droughts and doubles.
+class FourteenBagRandomizer final : public Randomizer {
+public:
+    [[nodiscard]] PieceType next(Rng &rng) override;
+    [[nodiscard]] RandomizerState save() const override;
+    void restore(const RandomizerState &state) override;
+
+private:
+    std::array<PieceType, 2 * PIECE_TYPE_COUNT> _bag{};
+    size_t _index{2 * PIECE_TYPE_COUNT};
+};
+
+// Classic: each piece uniformly random, independent of the previous ones.
+class MemorylessRandomizer final : public Randomizer {
+public:
+    [[nodiscard]] PieceType next(Rng &rng) override;
+};
+
+// TGM-style: reroll up to kRolls times while the roll is in the last four pieces.
+// The first piece is never S, Z or O.
+class TgmHistoryRandomizer final : public Randomizer {
+public:
+    static constexpr int kRolls = 6;
+
+    [[nodiscard]] PieceType next(Rng &rng) override;
+    [[nodiscard]] RandomizerState save() const override;
+    void restore(const RandomizerState &state) override;
+
+private:
+    std::array<PieceType, 4> _history{PieceType::Z, PieceType::S, PieceType::S, PieceType::Z};
+    bool _first{true};
+};
+
+std::unique_ptr<Randomizer> makeRandomizer(RandomizerType type = RandomizerType::SevenBag);
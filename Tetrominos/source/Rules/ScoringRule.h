@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -16,10 +18,84 @@ public:
                                               int level) const = 0;
 };
 
+// Guideline scoring at level 1. Only evaluated at compile time, to fill kGuidelineScores.
+[[nodiscard]] constexpr ScoreResult guidelineScore(const int linesCleared, const bool tSpin, const bool miniTSpin,
+                                                   const bool b2bActive) {
+    int value = 0;
+    int awardedLines = linesCleared;
+    bool continuesB2B = b2bActive;
+    bool b2bBonus = false;
+
+    if (tSpin) {
+        if (linesCleared <= 3) {
+            value = 400 * (linesCleared + 1);
+            awardedLines = 4 * (linesCleared + 1);
+        }
+        if (linesCleared >= 1) {
+            b2bBonus = b2bActive;
+            continuesB2B = true;
+        }
+    } else if (miniTSpin) {
+        if (linesCleared == 1) {
+            value = 200;
+            awardedLines = 2;
+            b2bBonus = b2bActive;
+            continuesB2B = true;
+        } else {
+            value = 100;
+            awardedLines = 1;
+        }
+    } else if (linesCleared >= 1 && linesCleared <= 3) {
+        value = 200 * linesCleared - 100;
+        awardedLines = 2 * linesCleared - 1;
+        continuesB2B = false;
+    } else if (linesCleared == 4) {
+        value = 800;
+        awardedLines = 8;
+        b2bBonus = b2bActive;
+        continuesB2B = true;
+    }
+
+    if (b2bBonus) {
+        value += value / 2;
+        awardedLines += (linesCleared + 1) / 2;
+    }
+    return {value, awardedLines, continuesB2B};
+}
+
+// Every guideline result at level 1, indexed by scoreIndex(). Points scale linearly with the level.
+inline constexpr int kScoreLines = 5; // 0-4 lines
+inline constexpr int kScoreCount = 3 * kScoreLines * 2;
+
+[[nodiscard]] constexpr int scoreIndex(const int linesCleared, const bool tSpin, const bool miniTSpin,
+                                       const bool b2bActive) {
+    const int spin = tSpin ? 2 : miniTSpin ? 1 : 0;
+    return (spin * kScoreLines + linesCleared) * 2 + (b2bActive ? 1 : 0);
+}
+
+inline constexpr std::array<ScoreResult, kScoreCount> kGuidelineScores = [] {
+    std::array<ScoreResult, kScoreCount> table{};
+    for (int lines = 0; lines < kScoreLines; lines++)
+        for (const bool b2b : {false, true}) {
+            table[static_cast<size_t>(scoreIndex(lines, false, false, b2b))] = guidelineScore(lines, false, false, b2b);
+            table[static_cast<size_t>(scoreIndex(lines, false, true, b2b))] = guidelineScore(lines, false, true, b2b);
+            table[static_cast<size_t>(scoreIndex(lines, true, false, b2b))] = guidelineScore(lines, true, false, b2b);
+        }
+    return table;
+}();
+
+static_assert(kGuidelineScores[scoreIndex(4, false, false, true)].points == 1200);
+static_assert(kGuidelineScores[scoreIndex(2, true, false, false)].awardedLines == 12);
+
 class GuidelineScoringRule final : public ScoringRule {
 public:
-    [[nodiscard]] ScoreResult compute(int linesCleared, bool tSpin, bool miniTSpin, bool b2bActive,
-                                      int level) const override;
+    [[nodiscard]] ScoreResult compute(const int linesCleared, const bool tSpin, const bool miniTSpin,
+                                      const bool b2bActive, const int level) const override {
+        const int index = scoreIndex(linesCleared, tSpin, miniTSpin, b2bActive);
+        ScoreResult result = kGuidelineScores[static_cast<size_t>(index)];
+        result.points *= level;
+        return result;
+    }
 };
 
 std::unique_ptr<ScoringRule> makeDefaultScoringRule();
@@ -0,0 +1,54 @@
+#include "TickTimings.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GravityPolicy.h"
+#include "VariantRule.h"
+
+using namespace std;
+
+static constexpr double kGenerationDelay = 0.2;
+static constexpr double kAutorepeatDelay = 0.25;
+static constexpr double kAutorepeatSpeed = 0.01;
+static constexpr double kAnimateDuration = 0.4;
+static constexpr double kFlashInterval = 0.1;
+static constexpr double kTrailDuration = 0.15;
+static constexpr double kFrameRate = 60.0; // G is counted in cells per frame at this rate
+
+const LevelTimings &TickTimings::level(const int level) const {
+    return levels[static_cast<size_t>(clamp(level, MIN_LEVEL, MAX_MASTER_LEVEL) - MIN_LEVEL)];
+}
+
+int64_t TickTimings::ticks(const double seconds) const {
+    return max<int64_t>(1, llround(seconds * tickRate));
+}
+
+// Intervals of at least a tick are rounded to whole ticks first and the
+// gravity rounded up, so a row falls exactly every ticks(secondsPerRow) ticks.
+// Shorter intervals keep their fraction. Either way gravity stops at 20G.
+int64_t TickTimings::gravity(const double secondsPerRow) const {
+    const double ticksPerRow = secondsPerRow * tickRate;
+    const double cells = ticksPerRow >= 1.0 ? 1.0 / static_cast<double>(ticks(secondsPerRow)) : 1.0 / ticksPerRow;
+    const double maxCells = kMaxGravity * kFrameRate / tickRate;
+    return static_cast<int64_t>(ceil(static_cast<double>(kGravityOne) * min(cells, maxCells)));
+}
+
+TickTimings makeTickTimings(const int tickRate, const GravityPolicy &gravity, const VariantRule &variant) {
+    TickTimings timings;
+    timings.tickRate = tickRate;
+    timings.generationDelay = timings.ticks(kGenerationDelay);
+    timings.autorepeatDelay = timings.ticks(kAutorepeatDelay);
+    timings.autorepeatInterval = timings.ticks(kAutorepeatSpeed);
+    timings.animateDuration = timings.ticks(kAnimateDuration);
+    timings.flashInterval = timings.ticks(kFlashInterval);
+    timings.hardDropTrail = timings.ticks(kTrailDuration);
+
+    for (int level = MIN_LEVEL; level <= MAX_MASTER_LEVEL; level++) {
+        auto &entry = timings.levels[static_cast<size_t>(level - MIN_LEVEL)];
+        entry.gravity = timings.gravity(gravity.fallInterval(level, DropType::Normal));
+        entry.softGravity = timings.gravity(gravity.fallInterval(level, DropType::Soft));
+        entry.lockDelay = timings.ticks(variant.lockDelay(level));
+    }
+    return timings;
+}
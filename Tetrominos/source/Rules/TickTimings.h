@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Constants.h"
+
+class GravityPolicy;
+class VariantRule;
+
+// Gravity is a fixed-point number of cells per tick: kGravityOne is 1 cell
+// per tick, so fractional G below a cell per tick keeps its precision.
+inline constexpr int64_t kGravityOne = int64_t{1} << 32;
+inline constexpr double kMaxGravity = 20.0; // 20G: 20 cells per 1/60 s frame
+
+// Per-level timings.
+struct LevelTimings {
+    int64_t gravity{};     // cells per tick under normal gravity, kGravityOne units
+    int64_t softGravity{}; // cells per tick while soft dropping
+    int64_t lockDelay{};   // ticks
+};
+
+// Every rule timing as a whole number of ticks at one tick rate. The table is
+// built once when the rate, the gravity policy or the variant changes, so the
+// per-tick path compares integers and never evaluates the gravity curve.
+// Durations round to the nearest tick and are at least one tick.
+struct TickTimings {
+    int tickRate{DEFAULT_TICK_RATE};
+    int64_t generationDelay{};    // ARE: delay before the next piece spawns
+    int64_t autorepeatDelay{};    // DAS
+    int64_t autorepeatInterval{}; // ARR
+    int64_t animateDuration{};    // line clear flash
+    int64_t flashInterval{};
+    int64_t hardDropTrail{};
+    std::array<LevelTimings, MAX_MASTER_LEVEL> levels{}; // levels[level - 1]
+
+    [[nodiscard]] const LevelTimings &level(int level) const; // clamped to MIN_LEVEL..MAX_MASTER_LEVEL
+    [[nodiscard]] int64_t ticks(double seconds) const;
+    [[nodiscard]] int64_t gravity(double secondsPerRow) const;
+};
+
+[[nodiscard]] TickTimings makeTickTimings(int tickRate, const GravityPolicy &gravity, const VariantRule &variant);
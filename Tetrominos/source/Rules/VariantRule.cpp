@@ -1,10 +1,18 @@
 #include "VariantRule.h"
 
+#include <algorithm>
+
+double MasterVariant::lockDelay(const int level) const {
+    const int past = std::clamp(level - MAX_LEVEL, 0, MAX_MASTER_LEVEL - MAX_LEVEL);
+    return kLockDownDelay - (kLockDownDelay - kMasterLockDelay) * past / (MAX_MASTER_LEVEL - MAX_LEVEL);
+}
+
 std::unique_ptr<VariantRule> makeVariantRule(const GameVariant variant) {
     switch (variant) {
         case GameVariant::Marathon: return std::make_unique<MarathonVariant>();
         case GameVariant::Sprint: return std::make_unique<SprintVariant>();
         case GameVariant::Ultra: return std::make_unique<UltraVariant>();
+        case GameVariant::Master: return std::make_unique<MasterVariant>();
     }
     return std::make_unique<MarathonVariant>();
 }
\ No newline at end of file
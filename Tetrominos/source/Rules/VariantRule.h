@@ -5,6 +5,9 @@
 
 #include "Constants.h"
 
+static constexpr double kLockDownDelay = 0.5;
+static constexpr double kMasterLockDelay = 0.2; // at MAX_MASTER_LEVEL
+
 class VariantRule {
 public:
     virtual ~VariantRule() = default;
@@ -12,6 +15,8 @@ public:
     [[nodiscard]] virtual bool levelUp() const = 0;
     [[nodiscard]] virtual double timeLimit() const = 0;
     [[nodiscard]] virtual bool showGoal() const = 0;
+    [[nodiscard]] virtual int maxLevel() const = 0; // the game ends when the level passes it
+    [[nodiscard]] virtual double lockDelay(int level) const = 0;
 };
 
 class MarathonVariant final : public VariantRule {
@@ -20,6 +25,8 @@ public:
     [[nodiscard]] bool levelUp() const override { return true; }
     [[nodiscard]] double timeLimit() const override { return -1; }
     [[nodiscard]] bool showGoal() const override { return true; }
+    [[nodiscard]] int maxLevel() const override { return MAX_LEVEL; }
+    [[nodiscard]] double lockDelay(int) const override { return kLockDownDelay; }
 };
 
 class SprintVariant final : public VariantRule {
@@ -28,13 +35,31 @@ public:
     [[nodiscard]] bool levelUp() const override { return false; }
     [[nodiscard]] double timeLimit() const override { return -1; }
     [[nodiscard]] bool showGoal() const override { return false; }
+    [[nodiscard]] int maxLevel() const override { return MAX_LEVEL; }
+    [[nodiscard]] double lockDelay(int) const override { return kLockDownDelay; }
 };
 
 class UltraVariant final : public VariantRule {
+public:
     [[nodiscard]] int linesGoal() const override { return -1; }
     [[nodiscard]] bool levelUp() const override { return false; }
     [[nodiscard]] double timeLimit() const override { return 120.0; }
     [[nodiscard]] bool showGoal() const override { return false; }
+    [[nodiscard]] int maxLevel() const override { return MAX_LEVEL; }
+    [[nodiscard]] double lockDelay(int) const override { return kLockDownDelay; }
+};
+
+// Marathon that carries on past MAX_LEVEL up to MAX_MASTER_LEVEL. Gravity keeps
+// following the curve to its 20G cap while the lock delay shrinks level by
+// level down to kMasterLockDelay.
+class MasterVariant final : public VariantRule {
+public:
+    [[nodiscard]] int linesGoal() const override { return -1; }
+    [[nodiscard]] bool levelUp() const override { return true; }
+    [[nodiscard]] double timeLimit() const override { return -1; }
+    [[nodiscard]] bool showGoal() const override { return true; }
+    [[nodiscard]] int maxLevel() const override { return MAX_MASTER_LEVEL; }
+    [[nodiscard]] double lockDelay(int level) const override;
 };
 
 std::unique_ptr<VariantRule> makeVariantRule(GameVariant variant = GameVariant::Marathon);
\ No newline at end of file
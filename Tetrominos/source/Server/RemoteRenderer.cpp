@@ -0,0 +1,209 @@
+#include "RemoteRenderer.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Color.h"
+#include "Constants.h"
+#include "GameState.h"
+#include "PieceData.h"
+#include "Session.h"
+#include "Utility.h"
+
+using namespace std;
+
+static constexpr int kSideX = 1; // hold and stats
+static constexpr int kFieldX = 14; // left border of the playfield
+static constexpr int kFieldY = 1; // top border
+static constexpr int kNextX = kFieldX + 2 * BOARD_WIDTH + 3;
+static constexpr int kValueX = kSideX + 6; // stat values, right of their label
+static constexpr int kStatusY = RemoteRenderer::kHeight - 1;
+
+// Decodes the UTF-8 sequence at text[i] and moves i past it. The game's
+// strings are valid UTF-8, so malformed input is not checked for.
+static char32_t nextCodePoint(const string_view text, size_t &i) {
+    const auto lead = static_cast<unsigned char>(text[i++]);
+    if (lead < 0x80) return lead;
+    const int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : 1;
+    auto codePoint = static_cast<char32_t>(lead & (0x3F >> extra));
+    for (int n = 0; n < extra && i < text.size(); n++)
+        codePoint = (codePoint << 6) | (static_cast<unsigned char>(text[i++]) & 0x3Fu);
+    return codePoint;
+}
+
+static void appendUtf8(string &out, const char32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+RemoteRenderer::RemoteRenderer(OutputSink &output) : _output(output) {}
+
+void RemoteRenderer::clear() {
+    for (auto &row : _frame) row.fill(Cell{});
+}
+
+void RemoteRenderer::put(const int x, const int y, const char32_t glyph, const int foreground, const int background) {
+    if (x < 0 || x >= kWidth || y < 0 || y >= kHeight) return;
+    auto &cell = _frame[static_cast<size_t>(y)][static_cast<size_t>(x)];
+    cell.glyph = glyph;
+    cell.foreground = static_cast<uint8_t>(foreground);
+    cell.background = static_cast<uint8_t>(background);
+}
+
+void RemoteRenderer::drawText(int x, const int y, const string_view text, const int color) {
+    for (size_t i = 0; i < text.size();) put(x++, y, nextCodePoint(text, i), color, Color::BLACK);
+}
+
+void RemoteRenderer::drawPiece(const int x, const int y, const PieceType type, const int color) {
+    drawText(x, y, kPreviewLine1[static_cast<size_t>(type)], color);
+    drawText(x, y + 1, kPreviewLine2[static_cast<size_t>(type)], color);
+}
+
+void RemoteRenderer::drawBanner(const int line, const string_view text, const int color) {
+    size_t length = 0;
+    for (size_t i = 0; i < text.size(); length++) (void)nextCodePoint(text, i);
+    const int width = 2 * BOARD_WIDTH;
+    const int x = kFieldX + 1 + max(0, (width - static_cast<int>(length)) / 2);
+    for (int i = 0; i < width; i++) put(kFieldX + 1 + i, kFieldY + 1 + line, U' ', Color::BLACK, Color::BLACK);
+    drawText(x, kFieldY + 1 + line, text, color);
+}
+
+void RemoteRenderer::drawStatus(const string_view text) {
+    drawText(kSideX, kStatusY, text, Color::GREY);
+}
+
+void RemoteRenderer::drawGame(const GameState &state, const bool playfieldVisible) {
+    drawText(kSideX, kFieldY + 1, "Hold", Color::WHITE);
+    if (state.config.holdEnabled && state.pieces.hold) {
+        const Tetrimino &hold = *state.pieces.hold;
+        drawPiece(kSideX, kFieldY + 2, hold.getType(), state.pieces.isNewHold ? Color::DARKGREY : hold.getColor());
+    }
+
+    const auto stat = [this](const int y, const string_view label, const string &value) {
+        drawText(kSideX, y, label, Color::WHITE);
+        drawText(kValueX, y, value, Color::WHITE);
+    };
+    drawText(kSideX, 6, "Score", Color::WHITE);
+    drawText(kSideX, 7, Utility::valueToString(state.stats.score, 10),
+             state.stats.backToBackBonus ? Color::LIGHTGREEN : Color::WHITE);
+    drawText(kSideX, 9, Utility::timeToString(state.displayTime()), Color::WHITE);
+    stat(11, "Level", Utility::valueToString(state.stats.level, 6));
+    stat(12, "Lines", Utility::valueToString(state.stats.lines, 6));
+    if (state.config.showGoal) stat(13, "Goal", Utility::valueToString(state.stats.goal, 6));
+    stat(15, "TPM", Utility::valueToString(state.tpm(), 6));
+    stat(16, "LPM", Utility::valueToString(state.lpm(), 6));
+
+    drawText(kNextX, kFieldY + 1, "Next", Color::WHITE);
+    const auto previews = static_cast<size_t>(max(state.config.previewCount, 0));
+    for (size_t i = 0; i < previews; i++) {
+        const PieceType type = state.pieces.queue.peek(i);
+        drawPiece(kNextX, kFieldY + 2 + 3 * static_cast<int>(i), type, pieceColor(type));
+    }
+
+    drawPlayfield(state, playfieldVisible);
+}
+
+void RemoteRenderer::drawPlayfield(const GameState &state, const bool visible) {
+    const int right = kFieldX + 2 * BOARD_WIDTH + 1;
+    const int bottom = kFieldY + VISIBLE_ROWS + 1;
+    for (int x = kFieldX + 1; x < right; x++) {
+        put(x, kFieldY, U'═', Color::GREY, Color::BLACK);
+        put(x, bottom, U'═', Color::GREY, Color::BLACK);
+    }
+    for (int y = kFieldY + 1; y < bottom; y++) {
+        put(kFieldX, y, U'║', Color::GREY, Color::BLACK);
+        put(right, y, U'║', Color::GREY, Color::BLACK);
+    }
+    put(kFieldX, kFieldY, U'╔', Color::GREY, Color::BLACK);
+    put(right, kFieldY, U'╗', Color::GREY, Color::BLACK);
+    put(kFieldX, bottom, U'╚', Color::GREY, Color::BLACK);
+    put(right, bottom, U'╝', Color::GREY, Color::BLACK);
+    if (!visible) return;
+
+    const Tetrimino *tetrimino = state.pieces.current ? &*state.pieces.current : nullptr;
+    const int ghostDistance = tetrimino != nullptr && state.config.ghostEnabled ? state.dropDistance() : 0;
+    const auto &clearing = state.lineClear.rows;
+    const auto &trail = state.hardDropTrail;
+
+    for (int row = 0; row < VISIBLE_ROWS; row++) {
+        const int line = MATRIX_START + row;
+        const int y = kFieldY + 1 + row;
+        const bool flashing = state.phase == GamePhase::Animate && state.lineClear.flashOn &&
+                              find(clearing.begin(), clearing.end(), line) != clearing.end();
+
+        for (int column = 0; column < BOARD_WIDTH; column++) {
+            char32_t glyph = U'█';
+            int foreground = Color::WHITE;
+            int background = Color::BLACK;
+            if (flashing) {
+                // a flashing row is drawn in white blocks
+            } else if (tetrimino != nullptr && tetrimino->isMino(line, column)) {
+                foreground = tetrimino->getColor();
+            } else if (const int color = state.matrix.color(line, column)) {
+                glyph = U'░';
+                foreground = Color::BLACK;
+                background = color;
+            } else if (ghostDistance > 0 && tetrimino->isMino(line - ghostDistance, column)) {
+                foreground = Color::DARKGREY;
+            } else if (trail.active && trail.columns[static_cast<size_t>(column)] && line >= trail.visibleStartRow &&
+                       line < trail.endRow) {
+                glyph = U'░';
+                foreground = trail.color;
+            } else {
+                glyph = (line + column) % 2 != 0 ? U'░' : U'▒';
+                foreground = Color::DARKGREY;
+            }
+            const int x = kFieldX + 1 + 2 * column;
+            put(x, y, glyph, foreground, background);
+            put(x + 1, y, glyph, foreground, background);
+        }
+    }
+
+    if (state.phase == GamePhase::Animate) {
+        if (!state.lineClear.notificationText.empty())
+            drawBanner(VISIBLE_ROWS / 2 - 1, state.lineClear.notificationText, state.lineClear.notificationColor);
+        if (!state.lineClear.comboText.empty())
+            drawBanner(VISIBLE_ROWS / 2, state.lineClear.comboText, state.lineClear.comboColor);
+    }
+}
+
+void RemoteRenderer::present() {
+    string glyph;
+    int lastX = -1;
+    int lastY = -1;
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            const Cell &cell = _frame[static_cast<size_t>(y)][static_cast<size_t>(x)];
+            Cell &shown = _shown[static_cast<size_t>(y)][static_cast<size_t>(x)];
+            if (!_invalid && cell == shown) continue;
+
+            if (y != lastY || x != lastX + 1) _output.moveTo(x + 1, y + 1);
+            _output.setColor(cell.foreground, cell.background);
+            glyph.clear();
+            appendUtf8(glyph, cell.glyph);
+            _output.write(glyph);
+            shown = cell;
+            lastX = x;
+            lastY = y;
+        }
+    }
+    _invalid = false;
+    _output.flush();
+}
+
+void RemoteRenderer::invalidate() {
+    _invalid = true;
+}
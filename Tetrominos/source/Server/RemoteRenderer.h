@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+class GameState;
+class OutputSink;
+enum class PieceType : uint8_t;
+
+// Draws a game for a remote terminal. The GameRenderer cannot be used there:
+// its displays are Panels, which write to the server's own terminal.
+//
+// A frame is composed into a grid of character cells, then present() sends
+// only the cells that differ from the previous frame, so a frame where just
+// the timer changed costs a few bytes. The layout is kWidth x kHeight and
+// fits an 80x24 terminal: hold and stats on the left, the playfield, the next
+// queue on the right, and a status line at the bottom.
+class RemoteRenderer {
+public:
+    static constexpr int kWidth = 50;
+    static constexpr int kHeight = 24;
+
+    explicit RemoteRenderer(OutputSink &output);
+
+    // Starts a new frame with every cell blank.
+    void clear();
+    // Hold, stats, playfield and next queue. A hidden playfield is left blank (pause).
+    void drawGame(const GameState &state, bool playfieldVisible = true);
+    // A line of text centered over the playfield, `line` rows below its top.
+    void drawBanner(int line, std::string_view text, int color);
+    void drawStatus(std::string_view text);
+    void drawText(int x, int y, std::string_view text, int color);
+
+    // Sends the cells that changed since the last present().
+    void present();
+    // The next present() sends every cell, e.g. after the client's screen was cleared.
+    void invalidate();
+
+private:
+    struct Cell {
+        char32_t glyph{U' '};
+        uint8_t foreground{};
+        uint8_t background{};
+
+        bool operator==(const Cell &other) const {
+            return glyph == other.glyph && foreground == other.foreground && background == other.background;
+        }
+        bool operator!=(const Cell &other) const { return !(*this == other); }
+    };
+    using Grid = std::array<std::array<Cell, kWidth>, kHeight>;
+
+    void put(int x, int y, char32_t glyph, int foreground, int background);
+    void drawPlayfield(const GameState &state, bool visible);
+    void drawPiece(int x, int y, PieceType type, int color);
+
+    OutputSink &_output;
+    Grid _frame{};
+    Grid _shown{};
+    bool _invalid{true};
+};
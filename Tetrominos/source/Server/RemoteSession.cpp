@@ -0,0 +1,178 @@
+#include "RemoteSession.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Color.h"
+#include "KeyBindings.h"
+
+using namespace std;
+
+static constexpr double kFrameInterval = TickDriver::kFrameInterval;
+static constexpr double kNever = numeric_limits<double>::infinity();
+
+static constexpr GameVariant kVariants[] = {GameVariant::Marathon, GameVariant::Sprint, GameVariant::Ultra,
+                                            GameVariant::Master};
+static constexpr string_view kVariantNames[] = {"1  Marathon", "2  Sprint", "3  Ultra", "4  Master"};
+
+RemoteSession::RemoteSession(const uint64_t id, const int tickRate)
+    : _id(id), _tickRate(clamp(tickRate, MIN_TICK_RATE, MAX_TICK_RATE)), _state(_ticks.clock()),
+      _controller(_ticks.clock()), _renderer(_session.output) {
+    _output.setCursorVisible(false);
+    _session.output.clear();
+}
+
+void RemoteSession::receive(const string_view bytes) {
+    _usage.bytesIn += bytes.size();
+    const bool wasPending = _input.pending();
+    _input.receive(bytes);
+    if (!wasPending && _input.pending()) _pendingSince = _session.clock.now();
+}
+
+void RemoteSession::update(const bool render) {
+    const double now = _session.clock.now();
+    // A lone Escape counts once the rest of a sequence has had time to arrive
+    if (_input.pending() && now >= _pendingSince + KeyDecoder::kSequenceWait) _input.flush();
+    if (_screen == Screen::Playing)
+        play(now);
+    else
+        handleKeys(now);
+
+    if (_input.interrupted()) _finished = true;
+    const bool frameDue = _redraw || _screen == Screen::Playing; // the game's clock changes every frame
+    if (render && !_finished && frameDue && now >= _lastDraw + kFrameInterval) draw(now);
+}
+
+double RemoteSession::nextUpdate(const bool render) const {
+    if (_finished) return kNever;
+    double next = kNever;
+    if (_screen == Screen::Playing) {
+        if (const int64_t tick = nextStep(); tick != NO_DEADLINE) next = _ticks.tickTime(tick);
+    }
+    if (render && (_redraw || _screen == Screen::Playing)) next = min(next, _lastDraw + kFrameInterval);
+    if (_input.pending()) next = min(next, _pendingSince + KeyDecoder::kSequenceWait);
+    return next;
+}
+
+void RemoteSession::startGame(const GameVariant variant) {
+    _state.config.variant = variant;
+    _controller.configurePolicies(_state.config.mode);
+    _controller.configureVariant(variant, _state);
+    _controller.setTickRate(_tickRate);
+    _ticks.reset(_tickRate, 0, _session.clock.now());
+    _controller.start(_state);
+    _usage.games++;
+    setScreen(Screen::Playing);
+}
+
+// Steps the ticks up to the current one that have a deadline or a key change.
+// Keys that arrived since the last update are held from the current tick.
+void RemoteSession::play(const double now) {
+    const int64_t current = _ticks.catchUp(now, nextStep());
+    _events.clear();
+    _session.input.takeEvents(now, _events);
+    (void)_ticks.play(_events, current, false, [this] { return _controller.nextDeadline(_state); },
+                      [this](int64_t, int64_t, const InputSnapshot &input) { return runTick(input); });
+}
+
+int64_t RemoteSession::nextStep() const {
+    return _ticks.nextStep(_controller.nextDeadline(_state));
+}
+
+// Returns false when the game leaves the screen; the driver then forgets the
+// held keys, so the key that paused is not seen again on resuming.
+bool RemoteSession::runTick(const InputSnapshot &input) {
+    _usage.ticks++;
+    if (_ticks.takeResume()) _state.resumeGameTimer();
+
+    const StepResult result = _controller.step(_state, input);
+    for (const auto sound : _state.pendingSounds()) _session.audio.playSound(sound);
+    _state.clearPendingSounds();
+
+    if (result == StepResult::Continue) return true;
+    _state.pauseGameTimer();
+    setScreen(result == StepResult::PauseRequested ? Screen::Paused : Screen::GameOver);
+    return false;
+}
+
+// Keys of the title, pause and game over screens. Keys received while a game
+// runs are the game's, so whatever is left here is dropped.
+void RemoteSession::handleKeys(const double now) {
+    for (const KeyCode key : _input.keys()) {
+        const Screen before = _screen;
+        switch (_screen) {
+            case Screen::Title:
+                for (size_t i = 0; i < size(kVariants); i++)
+                    if (key == letterKey(static_cast<char>('1' + i))) startGame(kVariants[i]);
+                if (key == letterKey('Q')) _finished = true;
+                break;
+            case Screen::Paused:
+                if (key == KeyCode::Escape || key == KeyCode::F1 || key == KeyCode::Enter) {
+                    _ticks.resumeOnNextTick(); // the game timer resumes on the next tick, as in the console game
+                    _ticks.resync(now);
+                    setScreen(Screen::Playing);
+                } else if (key == letterKey('R')) {
+                    startGame(_state.config.variant);
+                } else if (key == letterKey('Q')) {
+                    setScreen(Screen::Title);
+                }
+                break;
+            case Screen::GameOver:
+                if (key == KeyCode::Enter || key == letterKey('R')) startGame(_state.config.variant);
+                else if (key == letterKey('Q')) setScreen(Screen::Title);
+                break;
+            case Screen::Playing: break;
+        }
+        if (_screen != before || _finished) break;
+    }
+    _input.discard();
+}
+
+void RemoteSession::setScreen(const Screen screen) {
+    _screen = screen;
+    _redraw = true;
+}
+
+void RemoteSession::draw(const double now) {
+    _renderer.clear();
+    switch (_screen) {
+        case Screen::Title:
+            _renderer.drawText(14, 3, "T E T R O M I N O S", Color::WHITE);
+            for (size_t i = 0; i < size(kVariantNames); i++)
+                _renderer.drawText(18, 7 + 2 * static_cast<int>(i), kVariantNames[i], Color::LIGHTCYAN);
+            _renderer.drawText(4, 17, "Move: arrows, A D    Soft drop: down, S", Color::GREY);
+            _renderer.drawText(4, 18, "Rotate: up, X, Z     Hard drop: space", Color::GREY);
+            _renderer.drawText(4, 19, "Hold: C              Pause: Esc", Color::GREY);
+            _renderer.drawStatus("1-4 start a game   Q quit");
+            break;
+        case Screen::Playing:
+            _renderer.drawGame(_state);
+            _renderer.drawStatus("Esc pause");
+            break;
+        case Screen::Paused:
+            _renderer.drawGame(_state, false);
+            _renderer.drawBanner(VISIBLE_ROWS / 2 - 1, "PAUSED", Color::WHITE);
+            _renderer.drawStatus("Esc resume   R restart   Q menu");
+            break;
+        case Screen::GameOver:
+            _renderer.drawGame(_state);
+            _renderer.drawBanner(VISIBLE_ROWS / 2 - 1, "GAME OVER", Color::LIGHTRED);
+            _renderer.drawStatus("Enter play again   Q menu");
+            break;
+    }
+    _renderer.present();
+    _usage.frames++;
+    _lastDraw = now;
+    _redraw = false;
+}
+
+void RemoteSession::restoreTerminal() {
+    _output.resetColors();
+    _session.output.clear();
+    _output.setCursorVisible(true);
+}
+
+size_t RemoteSession::memoryBytes() const {
+    return sizeof(*this) + _input.memoryBytes() + _output.memoryBytes() + _events.capacity() * sizeof(KeyEvent) +
+           _state.pendingSounds().capacity() * sizeof(GameSound) + _state.lineClear.rows.capacity() * sizeof(int);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Clock.h"
+#include "GameController.h"
+#include "GameState.h"
+#include "RemoteRenderer.h"
+#include "RemoteTerminal.h"
+#include "Session.h"
+#include "TickDriver.h"
+
+// What one session has cost the server so far.
+struct SessionUsage {
+    double cpuSeconds{}; // thread CPU time spent handling the session
+    uint64_t bytesIn{};
+    uint64_t bytesOut{};
+    int64_t ticks{}; // ticks the game was stepped on; ticks without a deadline or input are skipped
+    int64_t frames{};
+    int games{};
+};
+
+// One player of the server: a title screen to pick a variant, the game, and
+// pause and game over screens. The game runs on a TickDriver, as the console
+// game does: it is stepped only on the ticks where something happens (see
+// GameController::nextDeadline) and where the keys change, and a key press
+// holds its action for one frame from the tick it arrived on. Unlike the
+// console, the clock is not stepped to every frame. nextUpdate() tells the server when to call update()
+// again, so a session on a menu or paused costs nothing until a key arrives.
+// The session never blocks and never touches the socket: the server feeds it
+// bytes and sends what it draws.
+class RemoteSession {
+public:
+    RemoteSession(uint64_t id, int tickRate);
+    RemoteSession(const RemoteSession &) = delete;
+    RemoteSession &operator=(const RemoteSession &) = delete;
+
+    void receive(std::string_view bytes);
+    // Runs the ticks that are due. With `render`, draws a frame into the output
+    // buffer if one is due; the server passes false while the client is behind
+    // on reading.
+    void update(bool render);
+    // The clock time update() has work at next: the next tick to step or, with
+    // `render`, the next frame. Infinity when only a key can change anything.
+    [[nodiscard]] double nextUpdate(bool render) const;
+    // Moves the output produced so far to the end of `out`.
+    void takeOutput(std::string &out) { _output.take(out); }
+    // Queues the bytes that give the client its terminal back: default colors,
+    // a cleared screen and a visible cursor.
+    void restoreTerminal();
+
+    [[nodiscard]] bool finished() const { return _finished; }
+    [[nodiscard]] uint64_t id() const { return _id; }
+    [[nodiscard]] SessionUsage &usage() { return _usage; }
+    [[nodiscard]] const SessionUsage &usage() const { return _usage; }
+    // The session object and the buffers it owns. Rule policies and short
+    // strings are not counted, so this slightly underestimates.
+    [[nodiscard]] size_t memoryBytes() const;
+
+private:
+    enum class Screen { Title, Playing, Paused, GameOver };
+
+    void startGame(GameVariant variant);
+    void play(double now);
+    [[nodiscard]] int64_t nextStep() const;
+    [[nodiscard]] bool runTick(const InputSnapshot &input);
+    void handleKeys(double now);
+    void setScreen(Screen screen);
+    void draw(double now);
+
+    uint64_t _id;
+    int _tickRate;
+    SteadyClock _clock;
+    RemoteInput _input;
+    RemoteAudio _audio;
+    RemoteOutput _output;
+    Session _session{_clock, _input, _audio, _output};
+
+    TickDriver _ticks;
+    GameState _state;
+    GameController _controller;
+    RemoteRenderer _renderer;
+
+    Screen _screen{Screen::Title};
+    std::vector<KeyEvent> _events; // taken from the input by this update
+    double _lastDraw{-1e9};
+    double _pendingSince{}; // clock time the input's unfinished sequence began
+    bool _redraw{true};
+    bool _finished{};
+    SessionUsage _usage;
+};
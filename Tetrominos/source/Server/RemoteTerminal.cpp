@@ -0,0 +1,51 @@
+#include "RemoteTerminal.h"
+
+using namespace std;
+
+// rlutil color numbers in ANSI order: add 30 for a foreground, 40 for a background.
+static constexpr int kAnsiColors[] = {0, 4, 2, 6, 1, 5, 3, 7, 60, 64, 62, 66, 61, 65, 63, 67};
+
+void RemoteOutput::clear() {
+    _buffer += "\x1b[2J\x1b[H";
+}
+
+void RemoteOutput::moveTo(const int x, const int y) {
+    _buffer += "\x1b[";
+    _buffer += to_string(y);
+    _buffer += ';';
+    _buffer += to_string(x);
+    _buffer += 'H';
+}
+
+void RemoteOutput::setColor(const int foreground, const int background) {
+    if (foreground == _foreground && background == _background) return;
+
+    _buffer += "\x1b[";
+    if (foreground != _foreground) {
+        _buffer += to_string(30 + kAnsiColors[foreground & 0xF]);
+        if (background != _background) _buffer += ';';
+    }
+    if (background != _background) _buffer += to_string(40 + kAnsiColors[background & 0xF]);
+    _buffer += 'm';
+    _foreground = foreground;
+    _background = background;
+}
+
+void RemoteOutput::write(const string_view text) {
+    _buffer += text;
+}
+
+void RemoteOutput::setCursorVisible(const bool visible) {
+    _buffer += visible ? "\x1b[?25h" : "\x1b[?25l";
+}
+
+void RemoteOutput::resetColors() {
+    _buffer += "\x1b[0m";
+    _foreground = -1;
+    _background = -1;
+}
+
+void RemoteOutput::take(string &out) {
+    out += _buffer;
+    _buffer.clear();
+}
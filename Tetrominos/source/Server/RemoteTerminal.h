@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "KeyDecoder.h"
+#include "Session.h"
+
+// The Session parts of a player connected over a socket (see Server.h): keys
+// decoded from the bytes the client sends, silent audio, and ANSI text
+// collected in a buffer for the server to send.
+
+// Keys decoded from the client's bytes (KeyDecoder). A terminal reports key
+// presses only, so an action is active in the one poll() after its key
+// arrived; holding a key relies on the terminal's autorepeat.
+class RemoteInput final : public InputSource {
+public:
+    void receive(const std::string_view bytes) { _decoder.receive(bytes); }
+
+    [[nodiscard]] InputSnapshot poll() override { return _decoder.take(); }
+    // Keys received since the last poll() or discard(), for the session's own screens.
+    [[nodiscard]] const std::vector<KeyCode> &keys() const { return _decoder.keys(); }
+    void discard() { _decoder.discard(); }
+    // Ctrl-C or Ctrl-D was received.
+    [[nodiscard]] bool interrupted() const { return _decoder.interrupted(); }
+    // The bytes received end in an unfinished sequence; flush() gives up on its rest.
+    [[nodiscard]] bool pending() const { return _decoder.pending(); }
+    void flush() { _decoder.flush(); }
+    [[nodiscard]] size_t memoryBytes() const { return _decoder.memoryBytes(); }
+
+private:
+    KeyDecoder _decoder;
+};
+
+// Remote players hear nothing: the settings are kept so the game can read them
+// back, and sounds are dropped.
+class RemoteAudio final : public AudioSink {
+public:
+    void playSound(GameSound) override {}
+    void playMusic(const std::string &track) override { _track = track; }
+    void pauseMusic() override {}
+    void unpauseMusic() override {}
+    void stopMusic() override { _track.clear(); }
+    [[nodiscard]] bool musicEnded() const override { return false; }
+    [[nodiscard]] std::string currentMusic() const override { return _track; }
+
+    void setMusicVolume(const float volume) override { _musicVolume = volume; }
+    void setEffectVolume(const float volume) override { _effectVolume = volume; }
+    void setSoundtrackMode(const SoundtrackMode mode) override { _soundtrackMode = mode; }
+    [[nodiscard]] float musicVolume() const override { return _musicVolume; }
+    [[nodiscard]] float effectVolume() const override { return _effectVolume; }
+    [[nodiscard]] SoundtrackMode soundtrackMode() const override { return _soundtrackMode; }
+
+private:
+    std::string _track;
+    float _musicVolume{};
+    float _effectVolume{};
+    SoundtrackMode _soundtrackMode{};
+};
+
+// Appends ANSI escape sequences and text to a buffer. flush() does nothing:
+// the server takes the buffer and sends it when the socket accepts more. The
+// game area starts at the top-left corner of the client's terminal.
+class RemoteOutput final : public OutputSink {
+public:
+    void clear() override;
+    void moveTo(int x, int y) override;
+    void setColor(int foreground, int background) override;
+    void write(std::string_view text) override;
+    void flush() override {}
+    [[nodiscard]] int originX() const override { return 0; }
+    [[nodiscard]] int originY() const override { return 0; }
+
+    // Shows or hides the cursor and restores the default colors.
+    void setCursorVisible(bool visible);
+    void resetColors();
+
+    // Moves the buffered bytes to the end of `out`.
+    void take(std::string &out);
+    [[nodiscard]] bool empty() const { return _buffer.empty(); }
+    [[nodiscard]] size_t memoryBytes() const { return _buffer.capacity(); }
+
+private:
+    std::string _buffer;
+    int _foreground{-1};
+    int _background{-1};
+};
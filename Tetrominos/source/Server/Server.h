@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Constants.h"
+
+// Command-line options of tetrominos --serve.
+struct ServeOptions {
+    std::string socketPath;
+    int threads = 0; // 0 = one per hardware thread, at most 4
+    size_t maxSessions = 256;
+    int tickRate = DEFAULT_TICK_RATE;
+};
+
+// Hosts independent games (RemoteSession) for clients connecting to a Unix
+// domain socket, e.g. `socat -,raw,echo=0 UNIX-CONNECT:<path>`, in this one
+// process. A pool of worker threads waits on one epoll set that holds the
+// listening socket, the client sockets and one timer for a TimerWheel of the
+// sessions' next deadlines, so a session that waits for a key costs nothing.
+// Every fd is armed one-shot, so a session is handled by one worker at a time,
+// and a slow client never blocks a worker: output it has not read yet waits in
+// the session and no new frame is drawn until it has.
+//
+// Each session's CPU time (measured per thread around its handling), traffic
+// and memory are logged when it disconnects and summed on stderr every few
+// seconds. Runs until SIGINT or SIGTERM and returns the exit code. Linux only.
+int runServer(const ServeOptions &options);
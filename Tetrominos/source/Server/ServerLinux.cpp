@@ -0,0 +1,484 @@
+#include "Server.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "RemoteSession.h"
+#include "TimerWheel.h"
+
+using namespace std;
+
+static constexpr int kStatsIntervalSeconds = 10;
+static constexpr int kMaxEvents = 8; // per epoll_wait, so one worker does not take every ready session
+static constexpr size_t kReadSize = 4096;
+static constexpr int kMaxReadsPerEvent = 16; // a client flooding input yields after 64 KiB
+
+// What an epoll event is about: the low two bits of its tag; the session id is above them.
+enum class Source : uint64_t { Socket, Timers, Listener, Stop };
+
+static uint64_t eventTag(const uint64_t id, const Source source) {
+    return id << 2 | static_cast<uint64_t>(source);
+}
+
+// Workers log concurrently, so a line is formatted first and written in one call.
+template <class... Parts>
+static void logLine(const Parts &...parts) {
+    ostringstream line;
+    (line << ... << parts) << '\n';
+    cerr << line.str();
+}
+
+static double threadCpuSeconds() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+static double wallSeconds() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+// The time of the timer wheel: milliseconds of the sessions' SteadyClock.
+static uint64_t clockMillis() {
+    return static_cast<uint64_t>(SteadyClock().now() * 1000);
+}
+
+static size_t residentBytes() {
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+struct Connection {
+    Connection(const uint64_t id, const int socketFd, const int tickRate)
+        : session(id, tickRate), socket(socketFd), connectedAt(wallSeconds()) {}
+
+    [[nodiscard]] size_t memoryBytes() const {
+        return sizeof(Connection) - sizeof(RemoteSession) + session.memoryBytes() + pending.capacity();
+    }
+
+    mutex lock; // held while a worker handles the session
+    RemoteSession session;
+    int socket;
+    string pending; // output the socket has not accepted yet
+    double connectedAt;
+    double cpuAtLastStats{};
+    bool closed{};
+};
+
+class SessionServer {
+public:
+    explicit SessionServer(const ServeOptions &options) : _options(options) {}
+    ~SessionServer();
+    SessionServer(const SessionServer &) = delete;
+    SessionServer &operator=(const SessionServer &) = delete;
+
+    [[nodiscard]] bool listen();
+    void run();
+
+private:
+    void work();
+    void dispatch(const epoll_event &event);
+    void acceptClients();
+    void expireTimers();
+    void serve(Connection &connection, Source source, uint32_t events);
+    void setDeadline(uint64_t id, double seconds);
+    void armTimer(uint64_t deadline);
+    [[nodiscard]] bool readInput(Connection &connection);
+    [[nodiscard]] bool flush(Connection &connection);
+    void disconnect(Connection &connection, const char *reason);
+    void watch(int fd, uint64_t tag, uint32_t events, int operation);
+    [[nodiscard]] shared_ptr<Connection> find(uint64_t id);
+    void printStats(double seconds);
+
+    ServeOptions _options;
+    int _listener{-1};
+    int _epoll{-1};
+    int _stop{-1}; // eventfd, readable once the workers have to return
+    int _timer{-1}; // timerfd, set for the wheel's next expiry
+    atomic<bool> _stopping{false};
+
+    mutex _wheelLock; // taken after a connection's lock, never before
+    TimerWheel _wheel{clockMillis()}; // when each session's update() has work next
+    uint64_t _armedFor{}; // the wheel time _timer expires at; 0 when disarmed
+
+    mutex _registryLock; // taken after a connection's lock, never before
+    unordered_map<uint64_t, shared_ptr<Connection>> _connections;
+    uint64_t _nextId{1};
+    double _closedCpu{}; // CPU of sessions that ended since the last stats line
+};
+
+SessionServer::~SessionServer() {
+    if (_listener >= 0) {
+        close(_listener);
+        unlink(_options.socketPath.c_str());
+    }
+    if (_stop >= 0) close(_stop);
+    if (_timer >= 0) close(_timer);
+    if (_epoll >= 0) close(_epoll);
+}
+
+bool SessionServer::listen() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (_options.socketPath.empty() || _options.socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path must be 1-" << sizeof(address.sun_path) - 1 << " characters\n";
+        return false;
+    }
+    _options.socketPath.copy(address.sun_path, _options.socketPath.size());
+    const auto *socketAddress = reinterpret_cast<const sockaddr *>(&address);
+
+    // A socket file left by a server that did not shut down is replaced; one
+    // that still accepts connections belongs to a running server.
+    struct stat info {};
+    if (stat(address.sun_path, &info) == 0 && S_ISSOCK(info.st_mode)) {
+        const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool inUse = probe >= 0 && connect(probe, socketAddress, sizeof(address)) == 0;
+        if (probe >= 0) close(probe);
+        if (inUse) {
+            cerr << "Another server is listening on " << _options.socketPath << "\n";
+            return false;
+        }
+        unlink(address.sun_path);
+    }
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0 || bind(listener, socketAddress, sizeof(address)) != 0 || ::listen(listener, SOMAXCONN) != 0) {
+        cerr << "Cannot listen on " << _options.socketPath << ": " << strerror(errno) << "\n";
+        if (listener >= 0) close(listener);
+        return false;
+    }
+    _listener = listener;
+
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _stop = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (_epoll < 0 || _stop < 0 || _timer < 0) {
+        cerr << "Cannot create the event loop: " << strerror(errno) << "\n";
+        return false;
+    }
+    watch(_listener, eventTag(0, Source::Listener), EPOLLIN, EPOLL_CTL_ADD);
+    watch(_timer, eventTag(0, Source::Timers), EPOLLIN, EPOLL_CTL_ADD);
+    epoll_event stop{};
+    stop.events = EPOLLIN; // level-triggered and never read, so it wakes every worker
+    stop.data.u64 = eventTag(0, Source::Stop);
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _stop, &stop);
+    return true;
+}
+
+// The workers serve the sessions; this thread waits for SIGINT or SIGTERM and
+// prints the usage summary in between.
+void SessionServer::run() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr); // inherited by the workers
+
+    int threads = _options.threads;
+    if (threads <= 0) threads = static_cast<int>(min(max(thread::hardware_concurrency(), 1u), 4u));
+    vector<thread> workers;
+    workers.reserve(static_cast<size_t>(threads));
+    for (int i = 0; i < threads; i++) workers.emplace_back([this] { work(); });
+    logLine("Serving on ", _options.socketPath, " with ", threads, " threads, up to ", _options.maxSessions,
+            " sessions");
+
+    double lastStats = wallSeconds();
+    for (;;) {
+        timespec timeout{kStatsIntervalSeconds, 0};
+        const int received = sigtimedwait(&signals, nullptr, &timeout);
+        if (received == SIGINT || received == SIGTERM) break;
+        const double now = wallSeconds();
+        if (now - lastStats >= kStatsIntervalSeconds) {
+            printStats(now - lastStats);
+            lastStats = now;
+        }
+    }
+
+    _stopping = true;
+    const uint64_t one = 1;
+    (void)write(_stop, &one, sizeof(one));
+    for (auto &worker : workers) worker.join();
+
+    vector<shared_ptr<Connection>> remaining;
+    for (const auto &entry : _connections) remaining.push_back(entry.second);
+    for (const auto &connection : remaining) {
+        const lock_guard<mutex> guard(connection->lock);
+        disconnect(*connection, "server stopped");
+    }
+    logLine("Server stopped");
+}
+
+void SessionServer::work() {
+    epoll_event events[kMaxEvents];
+    while (!_stopping) {
+        const int count = epoll_wait(_epoll, events, kMaxEvents, -1);
+        for (int i = 0; i < count && !_stopping; i++) dispatch(events[i]);
+    }
+}
+
+void SessionServer::dispatch(const epoll_event &event) {
+    const auto source = static_cast<Source>(event.data.u64 & 3);
+    switch (source) {
+        case Source::Stop: return;
+        case Source::Listener:
+            acceptClients();
+            watch(_listener, event.data.u64, EPOLLIN, EPOLL_CTL_MOD);
+            return;
+        case Source::Timers: expireTimers(); return;
+        case Source::Socket:
+            // The session may have ended while this event was queued
+            if (const auto connection = find(event.data.u64 >> 2)) serve(*connection, source, event.events);
+            return;
+    }
+}
+
+void SessionServer::acceptClients() {
+    for (;;) {
+        const int client = accept4(_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) logLine("accept: ", strerror(errno));
+            return;
+        }
+
+        size_t active = 0;
+        {
+            const lock_guard<mutex> guard(_registryLock);
+            active = _connections.size();
+        }
+        if (active >= _options.maxSessions) {
+            static constexpr string_view kFull = "The server is full, try again later.\r\n";
+            (void)send(client, kFull.data(), kFull.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+            close(client);
+            continue;
+        }
+
+        shared_ptr<Connection> connection;
+        {
+            const lock_guard<mutex> guard(_registryLock);
+            const uint64_t id = _nextId++;
+            connection = make_shared<Connection>(id, client, _options.tickRate);
+            _connections.emplace(id, connection);
+            active = _connections.size();
+        }
+        const uint64_t id = connection->session.id();
+        logLine("Session ", id, " connected (", active, " active)");
+        watch(client, eventTag(id, Source::Socket), EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+        setDeadline(id, 0); // draws the title screen
+    }
+}
+
+// One worker takes every session that is due and rearms the timer first, so
+// the other workers can take the next expiry meanwhile.
+void SessionServer::expireTimers() {
+    uint64_t expirations = 0;
+    (void)read(_timer, &expirations, sizeof(expirations));
+
+    vector<uint64_t> due;
+    {
+        const lock_guard<mutex> guard(_wheelLock);
+        _wheel.advance(clockMillis(), due);
+        _armedFor = 0;
+        if (const auto next = _wheel.nextExpiry()) armTimer(*next);
+    }
+    watch(_timer, eventTag(0, Source::Timers), EPOLLIN, EPOLL_CTL_MOD);
+
+    for (const uint64_t id : due)
+        if (const auto connection = find(id)) serve(*connection, Source::Timers, 0);
+}
+
+// Input reaches the game at once; the wheel wakes the session for the ticks and
+// frames in between. A session that is waiting for its client to read only
+// gets the ticks until the socket is writable again.
+void SessionServer::serve(Connection &connection, const Source source, const uint32_t events) {
+    const lock_guard<mutex> guard(connection.lock);
+    if (connection.closed) return;
+
+    const double cpuStart = threadCpuSeconds();
+    RemoteSession &session = connection.session;
+    bool open = true;
+    if (source == Source::Socket && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0)
+        open = readInput(connection);
+    session.update(connection.pending.empty());
+    session.takeOutput(connection.pending);
+    open = open && flush(connection) && !session.finished();
+    session.usage().cpuSeconds += threadCpuSeconds() - cpuStart;
+
+    if (!open) {
+        disconnect(connection, session.finished() ? "quit" : "hung up");
+        return;
+    }
+    setDeadline(session.id(), session.nextUpdate(connection.pending.empty()));
+    // Rearming the socket from a timer event is harmless if a worker already
+    // holds an event for it: that worker waits for the lock, then rearms again.
+    const uint32_t socketEvents = EPOLLIN | EPOLLRDHUP | (connection.pending.empty() ? 0u : EPOLLOUT);
+    watch(connection.socket, eventTag(session.id(), Source::Socket), socketEvents, EPOLL_CTL_MOD);
+}
+
+// `seconds` is a SteadyClock time; infinity takes the session off the wheel.
+void SessionServer::setDeadline(const uint64_t id, const double seconds) {
+    const lock_guard<mutex> guard(_wheelLock);
+    if (isinf(seconds)) {
+        _wheel.cancel(id);
+        return;
+    }
+    const auto deadline = static_cast<uint64_t>(max(ceil(seconds * 1000), 0.0));
+    _wheel.schedule(id, deadline);
+    if (_armedFor == 0 || deadline < _armedFor) armTimer(deadline);
+}
+
+// Called with the wheel's lock held. The timer is set relative to now, so the
+// wheel's clock and the timerfd's need not share an epoch.
+void SessionServer::armTimer(const uint64_t deadline) {
+    const uint64_t now = clockMillis();
+    const uint64_t delay = deadline > now ? deadline - now : 0;
+    itimerspec expiry{};
+    expiry.it_value.tv_sec = static_cast<time_t>(delay / 1000);
+    expiry.it_value.tv_nsec = static_cast<long>(delay % 1000) * 1'000'000 + 1; // zero would disarm it
+    timerfd_settime(_timer, 0, &expiry, nullptr);
+    _armedFor = max<uint64_t>(deadline, 1);
+}
+
+bool SessionServer::readInput(Connection &connection) {
+    char buffer[kReadSize];
+    for (int reads = 0; reads < kMaxReadsPerEvent; reads++) {
+        const ssize_t received = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.session.receive({buffer, static_cast<size_t>(received)});
+            continue;
+        }
+        if (received == 0) return false;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return true;
+}
+
+bool SessionServer::flush(Connection &connection) {
+    const string &pending = connection.pending;
+    size_t sent = 0;
+    while (sent < pending.size()) {
+        const ssize_t count =
+            send(connection.socket, pending.data() + sent, pending.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (count > 0) {
+            sent += static_cast<size_t>(count);
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+    connection.session.usage().bytesOut += sent;
+    connection.pending.erase(0, sent);
+    return true;
+}
+
+// Called with the connection's lock held.
+void SessionServer::disconnect(Connection &connection, const char *reason) {
+    connection.closed = true;
+    connection.session.restoreTerminal();
+    connection.session.takeOutput(connection.pending);
+    (void)flush(connection);
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, connection.socket, nullptr);
+    close(connection.socket);
+    {
+        const lock_guard<mutex> guard(_wheelLock);
+        _wheel.cancel(connection.session.id());
+    }
+
+    const SessionUsage &usage = connection.session.usage();
+    const double seconds = max(wallSeconds() - connection.connectedAt, 1e-9);
+    size_t active = 0;
+    {
+        const lock_guard<mutex> guard(_registryLock);
+        _closedCpu += usage.cpuSeconds - connection.cpuAtLastStats;
+        _connections.erase(connection.session.id());
+        active = _connections.size();
+    }
+    logLine("Session ", connection.session.id(), " ", reason, " after ", seconds, " s: ", usage.games, " games, ",
+            usage.ticks, " ticks, ", usage.frames, " frames, cpu ", usage.cpuSeconds * 1000, " ms (",
+            100 * usage.cpuSeconds / seconds, "% of a core), ", usage.bytesIn, " B in, ", usage.bytesOut / 1024,
+            " KiB out, ", connection.memoryBytes() / 1024, " KiB (", active, " active)");
+}
+
+void SessionServer::watch(const int fd, const uint64_t tag, const uint32_t events, const int operation) {
+    epoll_event event{};
+    event.events = events | EPOLLONESHOT;
+    event.data.u64 = tag;
+    epoll_ctl(_epoll, operation, fd, &event);
+}
+
+shared_ptr<Connection> SessionServer::find(const uint64_t id) {
+    const lock_guard<mutex> guard(_registryLock);
+    const auto it = _connections.find(id);
+    return it == _connections.end() ? nullptr : it->second;
+}
+
+// One line per interval: sessions, their memory and the CPU they used, so the
+// box can be sized from the per-session averages.
+void SessionServer::printStats(const double seconds) {
+    vector<shared_ptr<Connection>> connections;
+    double cpu = 0;
+    {
+        const lock_guard<mutex> guard(_registryLock);
+        for (const auto &entry : _connections) connections.push_back(entry.second);
+        cpu = _closedCpu;
+        _closedCpu = 0;
+    }
+
+    size_t memory = 0;
+    double busiest = 0;
+    for (const auto &connection : connections) {
+        const lock_guard<mutex> guard(connection->lock);
+        const double used = connection->session.usage().cpuSeconds;
+        cpu += used - connection->cpuAtLastStats;
+        busiest = max(busiest, used - connection->cpuAtLastStats);
+        connection->cpuAtLastStats = used;
+        memory += connection->memoryBytes();
+    }
+    if (connections.empty() && cpu == 0) return;
+
+    size_t waiting = 0;
+    {
+        const lock_guard<mutex> guard(_wheelLock);
+        waiting = _wheel.size();
+    }
+    const size_t sessions = connections.size();
+    logLine(sessions, " sessions (", sessions - min(waiting, sessions), " idle until a key), ", memory / 1024,
+            " KiB in sessions (", sessions > 0 ? memory / sessions / 1024 : 0, " KiB each), process ",
+            residentBytes() / (1024 * 1024), " MiB resident; cpu ", 100 * cpu / seconds,
+            "% of a core (busiest session ", 100 * busiest / seconds, "%)");
+}
+
+int runServer(const ServeOptions &options) {
+    SessionServer server(options);
+    if (!server.listen()) return 1;
+    server.run();
+    return 0;
+}
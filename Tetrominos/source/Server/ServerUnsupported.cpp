@@ -0,0 +1,9 @@
+#include "Server.h"
+
+#include <iostream>
+
+// Built instead of ServerLinux.cpp where there is no epoll.
+int runServer(const ServeOptions &) {
+    std::cerr << "--serve is only supported on Linux\n";
+    return 1;
+}
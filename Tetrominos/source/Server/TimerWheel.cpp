@@ -0,0 +1,112 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+using namespace std;
+
+static constexpr uint64_t kSlotMask = TimerWheel::kSlots - 1;
+
+static constexpr int shiftOf(const int level) {
+    return level * TimerWheel::kSlotBits;
+}
+
+void TimerWheel::schedule(const uint64_t id, const uint64_t deadline) {
+    const auto [it, added] = _entries.try_emplace(id);
+    if (!added) unlink(it->second);
+    it->second.deadline = deadline;
+    place(id, it->second);
+}
+
+void TimerWheel::cancel(const uint64_t id) {
+    const auto it = _entries.find(id);
+    if (it == _entries.end()) return;
+    unlink(it->second);
+    _entries.erase(it);
+}
+
+// Slots are indexed by the deadline's bits at the level, so the slot of the
+// current tick at level n holds nothing until the wheel reaches it, and the 63
+// slots after it cover the ticks up to 64^(n+1) past the start of its span.
+void TimerWheel::place(const uint64_t id, Entry &entry) {
+    int level = 0;
+    uint64_t slot = _now & kSlotMask; // a deadline that has passed waits in the current slot
+    if (entry.deadline > _now) {
+        for (level = 0; level < kLevels; level++) {
+            const int shift = shiftOf(level);
+            const uint64_t spanEnd = ((_now >> shift) + kSlots) << shift;
+            if (entry.deadline < spanEnd) break;
+        }
+        if (level == kLevels) {
+            level = kLevels - 1;
+            slot = ((_now >> shiftOf(level)) + kSlots - 1) & kSlotMask;
+        } else {
+            slot = (entry.deadline >> shiftOf(level)) & kSlotMask;
+        }
+    }
+
+    auto &ids = _slots[static_cast<size_t>(level)][slot];
+    entry.level = static_cast<uint8_t>(level);
+    entry.slot = static_cast<uint8_t>(slot);
+    entry.index = static_cast<uint32_t>(ids.size());
+    ids.push_back(id);
+    _occupied[static_cast<size_t>(level)] |= uint64_t{1} << slot;
+}
+
+void TimerWheel::unlink(const Entry &entry) {
+    auto &ids = _slots[entry.level][entry.slot];
+    if (entry.index + 1 < ids.size()) {
+        ids[entry.index] = ids.back();
+        _entries[ids[entry.index]].index = entry.index;
+    }
+    ids.pop_back();
+    if (ids.empty()) _occupied[entry.level] &= ~(uint64_t{1} << entry.slot);
+}
+
+void TimerWheel::advance(const uint64_t now, vector<uint64_t> &expired) {
+    for (auto next = nextExpiry(); next && *next <= now; next = nextExpiry()) {
+        _now = max(_now, *next);
+        expireCurrentSlots(expired);
+    }
+    _now = max(_now, now);
+}
+
+// The slots the wheel has just reached: from the top down, their ids move to
+// lower levels or expire, then the current tick's slot expires.
+void TimerWheel::expireCurrentSlots(vector<uint64_t> &expired) {
+    for (int level = kLevels - 1; level >= 0; level--) {
+        const auto index = static_cast<size_t>(level);
+        const uint64_t slot = (_now >> shiftOf(level)) & kSlotMask;
+        if ((_occupied[index] & (uint64_t{1} << slot)) == 0) continue;
+
+        _moving.swap(_slots[index][slot]);
+        _occupied[index] &= ~(uint64_t{1} << slot);
+        for (const uint64_t id : _moving) {
+            const auto it = _entries.find(id);
+            if (it->second.deadline <= _now) {
+                expired.push_back(id);
+                _entries.erase(it);
+            } else {
+                place(id, it->second);
+            }
+        }
+        _moving.clear();
+    }
+}
+
+optional<uint64_t> TimerWheel::nextExpiry() const {
+    optional<uint64_t> next;
+    for (int level = 0; level < kLevels; level++) {
+        const uint64_t occupied = _occupied[static_cast<size_t>(level)];
+        if (occupied == 0) continue;
+
+        const int shift = shiftOf(level);
+        const uint64_t current = _now >> shift;
+        for (uint64_t ahead = 0; ahead < kSlots; ahead++) {
+            if ((occupied & (uint64_t{1} << ((current + ahead) & kSlotMask))) == 0) continue;
+            const uint64_t start = max(_now, (current + ahead) << shift);
+            if (!next || start < *next) next = start;
+            break;
+        }
+    }
+    return next;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// The deadlines of many sessions, each waiting on at most one, in a
+// hierarchical timing wheel: four levels of 64 slots, a slot of level n
+// spanning 64^n ticks, so a deadline up to 2^24 ticks away (4.6 hours of
+// milliseconds) is scheduled, cancelled and expired in constant time. A
+// deadline goes to the lowest level whose slots reach it and moves down when
+// the wheel reaches its slot; one farther away waits in the top level's last
+// slot and is placed again from there. Not thread-safe.
+class TimerWheel {
+public:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+
+    explicit TimerWheel(const uint64_t now) : _now(now) {}
+
+    // Sets the deadline of `id`, replacing the one it had. A deadline that has
+    // passed expires on the next advance().
+    void schedule(uint64_t id, uint64_t deadline);
+    void cancel(uint64_t id);
+    // Moves the wheel to `now` and appends the ids whose deadline has come to `expired`.
+    void advance(uint64_t now, std::vector<uint64_t> &expired);
+    // The tick advance() next has work at: the earliest deadline, or earlier
+    // when a farther one moves down a level first. Empty when nothing waits.
+    [[nodiscard]] std::optional<uint64_t> nextExpiry() const;
+    [[nodiscard]] size_t size() const { return _entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t deadline{};
+        uint32_t index{}; // in its slot
+        uint8_t level{};
+        uint8_t slot{};
+    };
+
+    void place(uint64_t id, Entry &entry);
+    void unlink(const Entry &entry);
+    void expireCurrentSlots(std::vector<uint64_t> &expired);
+
+    uint64_t _now;
+    std::array<std::array<std::vector<uint64_t>, kSlots>, kLevels> _slots;
+    std::array<uint64_t, kLevels> _occupied{}; // one bit per slot that holds an id
+    std::unordered_map<uint64_t, Entry> _entries;
+    std::vector<uint64_t> _moving; // the slot being emptied
+};
@@ -0,0 +1,342 @@
+#include "DeadlineCheck.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <thread>
+
+#include "GameController.h"
+#include "GameState.h"
+#include "Replay.h"
+#include "Rng.h"
+#include "SimState.h"
+#include "TickDriver.h"
+#include "TimerWheel.h"
+
+using namespace std;
+
+namespace {
+
+constexpr const char *kVariantNames[] = {"marathon", "sprint", "ultra", "master"};
+constexpr const char *kLockDownNames[] = {"extended", "infinity", "classic"};
+
+struct RuleSet {
+    GameVariant variant;
+    LockDownMode mode;
+    bool sonicDrop;
+    bool guideline; // GuidelineController<Variant> instead of the runtime GameController
+    bool stepFrames; // the console steps the last tick of every frame; the server only the ticks due
+};
+
+vector<RuleSet> ruleSets() {
+    vector<RuleSet> sets;
+    for (size_t v = 0; v < VARIANT_COUNT; v++) {
+        const auto variant = static_cast<GameVariant>(v);
+        for (const bool stepFrames : {true, false}) {
+            for (const LockDownMode mode :
+                 {LockDownMode::Extended, LockDownMode::ExtendedInfinity, LockDownMode::Classic})
+                for (const bool sonicDrop : {false, true})
+                    sets.push_back({variant, mode, sonicDrop, false, stepFrames});
+            sets.push_back({variant, LockDownMode::Extended, false, true, stepFrames});
+        }
+    }
+    return sets;
+}
+
+// One game on its own TickDriver, fed the same key events as its twin.
+template <class Controller>
+struct Side {
+    TickDriver ticks;
+    GameState state{ticks.clock()};
+    Controller controller{ticks.clock()};
+
+    void start(const RuleSet &rules, const uint64_t seed, const int rate) {
+        state.config.variant = rules.variant;
+        state.config.mode = rules.mode;
+        state.config.sonicDrop = rules.sonicDrop;
+        state.config.seed = seed;
+        controller.configurePolicies(rules.mode);
+        controller.configureVariant(rules.variant, state);
+        controller.setTickRate(rate);
+        ticks.reset(rate, 0, 0);
+        controller.start(state);
+    }
+
+    StepResult step(const InputSnapshot &input) {
+        const StepResult result = controller.step(state, input);
+        state.clearPendingSounds();
+        return result;
+    }
+};
+
+// Everything a step can change that the player sees or the next step reads.
+struct Observed {
+    SimState sim;
+    GamePhase phase;
+    bool gameOver;
+    bool trailActive;
+    int trailRow;
+    bool flashOn;
+};
+
+Observed observe(const GameState &state) {
+    return {SimState::capture(state), state.phase,          state.flags.isGameOver, state.hardDropTrail.active,
+            state.hardDropTrail.visibleStartRow, state.lineClear.flashOn};
+}
+
+// The fall progress of a skipped tick is only applied by the next step.
+bool sameState(const Observed &a, const Observed &b, const bool withFallProgress) {
+    SimState x = a.sim;
+    SimState y = b.sim;
+    if (!withFallProgress) x.fallProgress = y.fallProgress = 0;
+    return memcmp(&x, &y, sizeof(SimState)) == 0 && a.phase == b.phase && a.gameOver == b.gameOver &&
+           a.trailActive == b.trailActive && a.trailRow == b.trailRow && a.flashOn == b.flashOn;
+}
+
+// No key, one or sometimes two, held for a tap or for long enough to autorepeat.
+InputSnapshot randomInput(Rng &rng) {
+    InputSnapshot input;
+    bool *const actions[] = {&input.left,     &input.right,     &input.softDrop, &input.hardDrop,
+                             &input.rotateCW, &input.rotateCCW, &input.hold};
+    if (rng.getInteger(0, 2) == 0) return input;
+    *actions[rng.getInteger(0, 6)] = true;
+    if (rng.getInteger(0, 3) == 0) *actions[rng.getInteger(0, 6)] = true;
+    return input;
+}
+
+// The wall time of the middle of `tick`, with the drivers' tick 0 at time 0.
+double tickMiddle(const int64_t tick, const int rate) {
+    return (static_cast<double>(tick) + 0.5) / static_cast<double>(rate);
+}
+
+struct PairResult {
+    int64_t denseTicks{};
+    int64_t sparseSteps{};
+    int games{};
+    string mismatch;
+};
+
+// The player's keys change at random ticks and the game is woken at random
+// frame ends, as the console and server are. Each frame gets an event for
+// every change of the keys in it and, while keys are down, a repeat, like the
+// console's key reader. The sparse game steps what TickDriver::run() picks;
+// the dense one gets the same events but a deadline on every tick, so it
+// steps them all.
+template <class Controller>
+PairResult checkPair(const RuleSet &rules, const uint64_t seed, const DeadlineCheckOptions &options) {
+    Side<Controller> dense;
+    Side<Controller> sparse;
+    dense.start(rules, seed, options.tickRate);
+    sparse.start(rules, seed, options.tickRate);
+
+    Rng rng(seed);
+    InputSnapshot keys;
+    int64_t change = 1; // the tick the keys change on next
+    const int frameTicks = max(1, options.tickRate / 10); // the console wakes at least every 0.1 s
+    vector<KeyEvent> events;
+    struct Step {
+        int64_t tick;
+        Observed observed;
+        StepResult result;
+    };
+    vector<Step> steps; // the sparse game's steps in this frame
+    Observed last = observe(sparse.state); // the sparse game after its last step
+    StepResult denseLast = StepResult::Continue; // the dense game's last step
+
+    PairResult result;
+    const auto fail = [&](const int64_t tick, const char *where) {
+        result.mismatch = string(kVariantNames[static_cast<size_t>(rules.variant)]) + ' ' +
+                          kLockDownNames[static_cast<size_t>(rules.mode)] + (rules.sonicDrop ? " sonic" : "") +
+                          (rules.guideline ? " guideline" : "") + (rules.stepFrames ? " console" : " server") +
+                          " seed " + to_string(seed) + ": tick " + to_string(tick) + ' ' + where;
+    };
+
+    for (int64_t frameEnd = 0; frameEnd < options.maxTicks && result.mismatch.empty();) {
+        const int64_t frameStart = frameEnd + 1;
+        frameEnd += rng.getInteger(0, 3) == 0 ? rng.getInteger(1, 5) : rng.getInteger(1, frameTicks);
+
+        events.clear();
+        int64_t lastEvent = frameStart;
+        for (; change <= frameEnd; change += rng.getInteger(0, 1) == 0 ? rng.getInteger(1, 30)
+                                                                        : rng.getInteger(1, 600)) {
+            keys = randomInput(rng);
+            lastEvent = max(change, frameStart);
+            events.push_back({tickMiddle(lastEvent, options.tickRate), keys});
+        }
+        if (packInput(keys) != 0 && rng.getInteger(0, 1) == 0) {
+            const auto repeat = static_cast<int64_t>(rng.getInteger(0, static_cast<int>(frameEnd - lastEvent)));
+            events.push_back({tickMiddle(lastEvent + repeat, options.tickRate), keys});
+        }
+
+        steps.clear();
+        (void)sparse.ticks.play(events, frameEnd, rules.stepFrames,
+                                [&] { return sparse.controller.nextDeadline(sparse.state); },
+                                [&](int64_t, const int64_t tick, const InputSnapshot &input) {
+                                    const StepResult step = sparse.step(input);
+                                    result.sparseSteps++;
+                                    steps.push_back({tick, observe(sparse.state), step});
+                                    return step != StepResult::GameOver;
+                                });
+
+        // The tick before a key event is stepped before it is held, even when the
+        // previous frame ended on it: the dense game has just stepped that one
+        size_t next = 0;
+        if (!steps.empty() && steps.front().tick == dense.ticks.tick()) {
+            last = steps[next++].observed;
+            if (steps.front().result != denseLast || !sameState(observe(dense.state), last, true)) {
+                fail(dense.ticks.tick(), "on a step");
+                break;
+            }
+        }
+        (void)dense.ticks.play(events, frameEnd, true, [&] { return dense.ticks.tick() + 1; },
+                               [&](int64_t, const int64_t tick, const InputSnapshot &input) {
+                                   const StepResult step = denseLast = dense.step(input);
+                                   result.denseTicks++;
+                                   const Observed observed = observe(dense.state);
+                                   if (next < steps.size() && steps[next].tick == tick) {
+                                       last = steps[next].observed;
+                                       if (step != steps[next++].result || !sameState(observed, last, true)) {
+                                           fail(tick, "on a step");
+                                           return false;
+                                       }
+                                   } else if (!sameState(observed, last, false)) {
+                                       fail(tick, "between steps");
+                                       return false;
+                                   }
+                                   return step != StepResult::GameOver;
+                               });
+        if (!result.mismatch.empty()) break;
+        if (next != steps.size() || dense.state.flags.isGameOver != sparse.state.flags.isGameOver) {
+            fail(dense.ticks.tick(), "after a frame");
+            break;
+        }
+        if (sparse.state.flags.isGameOver) {
+            result.games++;
+            dense.controller.start(dense.state);
+            sparse.controller.start(sparse.state);
+            last = observe(sparse.state);
+        }
+    }
+    return result;
+}
+
+PairResult checkGame(const RuleSet &rules, const uint64_t seed, const DeadlineCheckOptions &options) {
+    if (!rules.guideline) return checkPair<GameController>(rules, seed, options);
+
+    switch (rules.variant) {
+        case GameVariant::Marathon: return checkPair<GuidelineController<MarathonVariant>>(rules, seed, options);
+        case GameVariant::Sprint: return checkPair<GuidelineController<SprintVariant>>(rules, seed, options);
+        case GameVariant::Ultra: return checkPair<GuidelineController<UltraVariant>>(rules, seed, options);
+        case GameVariant::Master: return checkPair<GuidelineController<MasterVariant>>(rules, seed, options);
+    }
+    return checkPair<GameController>(rules, seed, options);
+}
+
+// Deadlines from a few ticks in the past to beyond the top level of the wheel,
+// and advances from one tick to many wheel turns.
+constexpr uint64_t kDeadlineSpans[] = {5, 64, 5000, 300000, 20000000, 200000000};
+constexpr uint64_t kAdvanceSpans[] = {1, 30, 700, 100000, 50000000};
+constexpr int kWheelOperations = 20000; // per round
+constexpr int kWheelIds = 300;
+
+uint64_t below(Rng &rng, const uint64_t bound) {
+    const uint64_t value = (static_cast<uint64_t>(rng.next()) << 32) | rng.next();
+    return value % bound;
+}
+
+string checkWheelRound(const uint64_t seed) {
+    Rng rng(seed);
+    uint64_t now = below(rng, 100000000);
+    TimerWheel wheel(now);
+    map<uint64_t, uint64_t> model; // id -> deadline
+    vector<uint64_t> expired;
+    vector<uint64_t> due;
+
+    for (int operation = 0; operation < kWheelOperations; operation++) {
+        const auto id = static_cast<uint64_t>(rng.getInteger(0, kWheelIds - 1));
+        const int kind = rng.getInteger(0, 9);
+        if (kind < 5) {
+            const uint64_t span = kDeadlineSpans[rng.getInteger(0, static_cast<int>(size(kDeadlineSpans)) - 1)];
+            const uint64_t late = rng.getInteger(0, 7) == 0 ? below(rng, 10) : 0;
+            const uint64_t deadline = now + below(rng, span) - min(late, now);
+            wheel.schedule(id, deadline);
+            model[id] = deadline;
+        } else if (kind < 6) {
+            wheel.cancel(id);
+            model.erase(id);
+        } else {
+            uint64_t earliest = UINT64_MAX;
+            for (const auto &[modelId, deadline] : model) earliest = min(earliest, max(deadline, now));
+            const optional<uint64_t> next = wheel.nextExpiry();
+            if (model.empty() != !next) return "nextExpiry() disagrees on whether anything waits";
+            if (next && *next > earliest) return "nextExpiry() " + to_string(*next) + " after " + to_string(earliest);
+
+            now += below(rng, kAdvanceSpans[rng.getInteger(0, static_cast<int>(size(kAdvanceSpans)) - 1)]);
+            expired.clear();
+            wheel.advance(now, expired);
+            due.clear();
+            for (auto it = model.begin(); it != model.end();) {
+                if (it->second > now) {
+                    ++it;
+                    continue;
+                }
+                due.push_back(it->first);
+                it = model.erase(it);
+            }
+            sort(expired.begin(), expired.end());
+            if (expired != due)
+                return "advance() expired " + to_string(expired.size()) + " ids, " + to_string(due.size()) + " due";
+        }
+        if (wheel.size() != model.size()) return "size() " + to_string(wheel.size()) + ", " + to_string(model.size());
+    }
+    return {};
+}
+
+} // namespace
+
+DeadlineCheckResult checkDeadlines(const DeadlineCheckOptions &options) {
+    const vector<RuleSet> sets = ruleSets();
+    const size_t perSet = static_cast<size_t>(max(options.games, 0));
+    const size_t total = perSet * sets.size();
+    const size_t rounds = static_cast<size_t>(max(options.wheelRounds, 0));
+
+    DeadlineCheckResult result;
+    result.threads = options.threads > 0 ? options.threads : static_cast<int>(max(thread::hardware_concurrency(), 1u));
+    result.threads = static_cast<int>(min(static_cast<size_t>(result.threads), max(total + rounds, size_t{1})));
+
+    // As in runSimulation(): workers pull job indices and write their own slot
+    vector<PairResult> pairs(total);
+    vector<string> wheelRounds(rounds);
+    atomic<size_t> nextJob{0};
+    const auto worker = [&] {
+        for (size_t job = nextJob++; job < total + rounds; job = nextJob++) {
+            if (job < total)
+                pairs[job] = checkGame(sets[job / perSet], options.seed + job % perSet, options);
+            else
+                wheelRounds[job - total] = checkWheelRound(options.seed + (job - total));
+        }
+    };
+
+    const auto begin = chrono::steady_clock::now();
+    vector<thread> threads;
+    threads.reserve(static_cast<size_t>(result.threads));
+    for (int i = 0; i < result.threads; i++) threads.emplace_back(worker);
+    for (auto &t : threads) t.join();
+    result.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    for (const PairResult &pair : pairs) {
+        result.denseTicks += pair.denseTicks;
+        result.sparseSteps += pair.sparseSteps;
+        result.games += pair.games;
+        if (!pair.mismatch.empty()) result.mismatches.push_back(pair.mismatch);
+    }
+    for (size_t round = 0; round < rounds; round++) {
+        if (!wheelRounds[round].empty())
+            result.wheelMismatches.push_back("round " + to_string(round) + ": " + wheelRounds[round]);
+    }
+    result.wheelOperations = static_cast<int64_t>(rounds) * kWheelOperations;
+    return result;
+}
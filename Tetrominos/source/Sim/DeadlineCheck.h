@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+
+struct DeadlineCheckOptions {
+    int games = 4;     // per rule set (variant, lock down, sonic drop, controller, console or server)
+    int threads = 0;   // 0 = one per hardware thread
+    uint64_t seed = 1; // game i of every rule set uses seed + i
+    int64_t maxTicks = 600000; // 10 minutes at the default tick rate
+    int tickRate = DEFAULT_TICK_RATE;
+    int wheelRounds = 50; // TimerWheel rounds of random schedule, cancel and advance
+};
+
+struct DeadlineCheckResult {
+    int64_t denseTicks{};  // ticks stepped by the games stepped every tick
+    int64_t sparseSteps{}; // steps of the games stepped at nextDeadline() and key changes
+    int games{};           // games played to game over, over all pairs
+    std::vector<std::string> mismatches; // one line per pair that diverged, at its first divergence
+    int64_t wheelOperations{};
+    std::vector<std::string> wheelMismatches; // one line per round that disagreed with the model
+    double wallSeconds{};
+    int threads{};
+};
+
+// Checks the invariant the server and the console loop rely on: stepping a
+// game only at GameController::nextDeadline() and at the ticks its keys
+// change, plus the tick before each, plays it exactly as stepping every tick.
+// Each pair runs the same seed, random frames and random key events through
+// two TickDrivers: one steps every tick, the other only the ticks
+// TickDriver::run() picks. After every tick the dense game's state must equal
+// the sparse one's, its fall progress aside until the sparse game steps.
+// Every variant runs with each lock-down mode and sonic drop setting on the
+// runtime GameController, and with its GuidelineController, once stepping the
+// last tick of each frame as the console does and once only the ticks due, as
+// the server does.
+//
+// The server's TimerWheel, which schedules those deadlines, is checked against
+// a std::map of the same deadlines over random schedule, cancel and advance
+// calls: advance() must expire exactly the due ids, and nextExpiry() must never
+// come after the earliest deadline.
+[[nodiscard]] DeadlineCheckResult checkDeadlines(const DeadlineCheckOptions &options);
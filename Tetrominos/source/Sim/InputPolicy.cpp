@@ -0,0 +1,156 @@
+#include "InputPolicy.h"
+
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+static InputSnapshot inputFor(const char action) {
+    InputSnapshot input;
+    switch (action) {
+        case 'L': input.left = true; break;
+        case 'R': input.right = true; break;
+        case 'D': input.softDrop = true; break;
+        case 'H': input.hardDrop = true; break;
+        case 'C': input.rotateCW = true; break;
+        case 'W': input.rotateCCW = true; break;
+        case 'X': input.hold = true; break;
+        default: break;
+    }
+    return input;
+}
+
+// ---------------------------------------------------------------------------
+// RandomInputPolicy
+// ---------------------------------------------------------------------------
+
+InputSnapshot RandomInputPolicy::next(const GameState &) {
+    // Seven actions plus a weighted "nothing" so presses are released often
+    // enough for rotations and taps to register.
+    static constexpr array<char, 12> kActions = {'L', 'R', 'D', 'H', 'C', 'W', 'X', '.', '.', '.', '.', '.'};
+    return inputFor(kActions[static_cast<size_t>(_rng.getInteger(0, static_cast<int>(kActions.size()) - 1))]);
+}
+
+// ---------------------------------------------------------------------------
+// ScriptedInputPolicy
+// ---------------------------------------------------------------------------
+
+ScriptedInputPolicy::ScriptedInputPolicy(string script) : _script(std::move(script)) {
+    if (_script.empty()) _script = ".";
+}
+
+InputSnapshot ScriptedInputPolicy::next(const GameState &) {
+    const char action = _script[_index];
+    _index = (_index + 1) % _script.size();
+    return inputFor(action);
+}
+
+// ---------------------------------------------------------------------------
+// BotInputPolicy
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Weights from the classic four-feature Tetris evaluation.
+constexpr double kHeightWeight = -0.510066;
+constexpr double kLinesWeight = 0.760666;
+constexpr double kHolesWeight = -0.35663;
+constexpr double kBumpinessWeight = -0.184483;
+
+double evaluate(const GameMatrix &matrix, const int lines) {
+    int aggregateHeight = 0;
+    int bumpiness = 0;
+    for (int column = 0; column < BOARD_WIDTH; column++) {
+        aggregateHeight += matrix.height(column);
+        if (column > 0) bumpiness += abs(matrix.height(column) - matrix.height(column - 1));
+    }
+
+    return kHeightWeight * aggregateHeight + kLinesWeight * lines + kHolesWeight * matrix.holeCount() +
+           kBumpinessWeight * bumpiness;
+}
+
+// Drops the piece, locks it into a copy of the matrix and scores the result.
+double scorePlacement(const GameMatrix &matrix, Tetrimino piece) {
+    while (piece.move(matrix, Vector2i(1, 0))) {
+    }
+
+    GameMatrix result = matrix;
+    if (!piece.lock(result)) return numeric_limits<double>::lowest();
+
+    vector<int> fullRows;
+    for (int row = BOARD_HEIGHT - 1; row >= 0; row--)
+        if (result.fullRows() & (uint64_t{1} << row)) fullRows.push_back(row);
+    if (!fullRows.empty()) result.eliminateRows(fullRows);
+
+    return evaluate(result, static_cast<int>(fullRows.size()));
+}
+
+} // namespace
+
+InputSnapshot BotInputPolicy::next(const GameState &state) {
+    if (_plan.empty() && state.phase == GamePhase::Falling && state.pieces.current) plan(state);
+    if (_plan.empty()) return {};
+
+    const InputSnapshot input = _plan.front();
+    _plan.pop_front();
+    return input;
+}
+
+void BotInputPolicy::plan(const GameState &state) {
+    const GameMatrix &matrix = state.matrix;
+
+    double bestScore = numeric_limits<double>::lowest();
+    int bestRotation = 0;
+    int bestShift = 0;
+
+    // 0 = as spawned, 1 = CW, 2 = CW twice, 3 = CCW
+    for (int rotation = 0; rotation < ROTATION_COUNT; rotation++) {
+        Tetrimino rotated = *state.pieces.current;
+        bool rotates = true;
+        if (rotation == 3)
+            rotates = rotated.rotate(matrix, Direction::Left);
+        else
+            for (int i = 0; i < rotation && rotates; i++)
+                rotates = rotated.rotate(matrix, Direction::Right);
+        if (!rotates) continue;
+
+        for (const int direction : {-1, 1}) {
+            Tetrimino shifted = rotated;
+            for (int shift = 0; shift < BOARD_WIDTH; shift++) {
+                if (shift > 0 && !shifted.move(matrix, Vector2i(0, direction))) break;
+                if (shift == 0 && direction > 0) continue; // already scored going left
+
+                if (const double score = scorePlacement(matrix, shifted); score > bestScore) {
+                    bestScore = score;
+                    bestRotation = rotation;
+                    bestShift = shift * direction;
+                }
+            }
+        }
+    }
+
+    const auto tap = [this](const char action) {
+        _plan.push_back(inputFor(action));
+        _plan.emplace_back();
+    };
+
+    if (bestRotation == 3)
+        tap('W');
+    else
+        for (int i = 0; i < bestRotation; i++) tap('C');
+    for (int i = 0; i < abs(bestShift); i++) tap(bestShift < 0 ? 'L' : 'R');
+    tap('H');
+}
+
+unique_ptr<InputPolicy> makeInputPolicy(const PolicyType type, const uint64_t seed, const string &script) {
+    switch (type) {
+        case PolicyType::Random: return make_unique<RandomInputPolicy>(seed);
+        case PolicyType::Scripted:
+            return script.empty() ? make_unique<ScriptedInputPolicy>() : make_unique<ScriptedInputPolicy>(script);
+        case PolicyType::Bot: return make_unique<BotInputPolicy>();
+    }
+    return make_unique<BotInputPolicy>();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "GameState.h"
+#include "InputSnapshot.h"
+#include "Rng.h"
+
+enum class PolicyType { Random, Scripted, Bot };
+
+// Drives a headless game: asked once per tick for the input held during that
+// tick. Policies only read the state, so they play through the same
+// GameController path (autorepeat, rotation edges, lock down) as a player.
+class InputPolicy {
+public:
+    virtual ~InputPolicy() = default;
+    [[nodiscard]] virtual InputSnapshot next(const GameState &state) = 0;
+};
+
+// Mashes buttons: each tick holds one random action, or nothing.
+class RandomInputPolicy final : public InputPolicy {
+public:
+    explicit RandomInputPolicy(uint64_t seed) : _rng(seed) {}
+    [[nodiscard]] InputSnapshot next(const GameState &state) override;
+
+private:
+    Rng _rng;
+};
+
+// Loops over a fixed script, one character per tick:
+//   L left, R right, D soft drop, H hard drop, C rotate CW, W rotate CCW,
+//   X hold, '.' nothing held.
+class ScriptedInputPolicy final : public InputPolicy {
+public:
+    static constexpr auto kDefaultScript = "C.L.L.H...R.R.R.H...W.H...X.L.H...";
+
+    explicit ScriptedInputPolicy(std::string script = kDefaultScript);
+    [[nodiscard]] InputSnapshot next(const GameState &state) override;
+
+private:
+    std::string _script;
+    size_t _index{};
+};
+
+// Greedy one-piece bot: tries every rotation and column for the current piece,
+// scores the resulting stack (height, holes, bumpiness, lines) and plays the
+// best one as press/release taps followed by a hard drop.
+class BotInputPolicy final : public InputPolicy {
+public:
+    [[nodiscard]] InputSnapshot next(const GameState &state) override;
+
+private:
+    void plan(const GameState &state);
+
+    std::deque<InputSnapshot> _plan;
+};
+
+[[nodiscard]] std::unique_ptr<InputPolicy> makeInputPolicy(PolicyType type, uint64_t seed,
+                                                           const std::string &script = {});
@@ -0,0 +1,157 @@
+#include "Perft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+
+#include "MoveGenerator.h"
+#include "PieceQueue.h"
+#include "Randomizer.h"
+#include "Rng.h"
+#include "SimState.h"
+#include "Zobrist.h"
+
+using namespace std;
+
+namespace {
+
+constexpr int kNoHold = -1;
+
+// A position below the first ply, handed to the worker threads. The matrix
+// and hold travel as a SimState so a job is two cache lines, not a GameMatrix.
+struct Job {
+    SimState state;
+    size_t next;
+
+    Job(const GameMatrix &matrix, const int hold, const size_t nextPiece) : next(nextPiece) {
+        state.storeMatrix(matrix);
+        state.hold = hold == kNoHold ? SimState::kNoPiece : static_cast<uint8_t>(hold);
+    }
+    [[nodiscard]] int hold() const { return state.hold == SimState::kNoPiece ? kNoHold : state.hold; }
+};
+
+struct Worker {
+    unique_ptr<MoveGenerator> generator = make_unique<MoveGenerator>();
+    vector<vector<Placement>> placements; // one buffer per ply
+    vector<uint64_t> nodes;
+    vector<unordered_set<uint64_t>> seen;
+    uint64_t generateCalls{};
+
+    explicit Worker(const size_t depth) : placements(depth), nodes(depth), seen(depth) {}
+};
+
+struct Search {
+    const PerftOptions &options;
+    const vector<PieceType> &pieces;
+    size_t depth;
+};
+
+// The matrix keeps its Zobrist hash current; the held piece adds one key.
+uint64_t stateHash(const GameMatrix &matrix, const int hold) {
+    return matrix.hash() ^ (hold == kNoHold ? 0 : zobristHold(static_cast<PieceType>(hold)));
+}
+
+void clearFullRows(GameMatrix &matrix) {
+    vector<int> fullRows;
+    for (int row = BOARD_HEIGHT - 1; row >= 0; row--)
+        if (matrix.isRowFull(row)) fullRows.push_back(row);
+    if (!fullRows.empty()) matrix.eliminateRows(fullRows);
+}
+
+void search(const Search &s, Worker &worker, const GameMatrix &matrix, int hold, size_t next, size_t ply,
+            vector<Job> *jobs);
+
+// Spawns `type`, places it everywhere it can rest and continues from each
+// result. With `jobs` set, the children are queued instead of searched.
+void place(const Search &s, Worker &worker, const GameMatrix &matrix, const PieceType type, const int hold,
+           const size_t next, const size_t ply, vector<Job> *jobs) {
+    Tetrimino piece(type);
+    if (!piece.setPosition(matrix, piece.getStartingPosition())) return;
+
+    auto &placements = worker.placements[ply];
+    worker.generator->generate(matrix, piece, placements);
+    worker.generateCalls++;
+
+    for (const auto &placement : placements) {
+        GameMatrix child = matrix;
+        if (Tetrimino locked = placement.piece; !locked.lock(child)) continue; // lock out
+        clearFullRows(child);
+
+        worker.nodes[ply]++;
+        if (s.options.distinct) worker.seen[ply].insert(stateHash(child, hold));
+
+        if (ply + 1 >= s.depth) continue;
+        if (jobs)
+            jobs->emplace_back(child, hold, next);
+        else
+            search(s, worker, child, hold, next, ply + 1, nullptr);
+    }
+}
+
+void search(const Search &s, Worker &worker, const GameMatrix &matrix, const int hold, const size_t next,
+            const size_t ply, vector<Job> *jobs) {
+    const PieceType current = s.pieces[next];
+    place(s, worker, matrix, current, hold, next + 1, ply, jobs);
+
+    if (!s.options.config.holdEnabled) return;
+    if (hold == kNoHold)
+        place(s, worker, matrix, s.pieces[next + 1], static_cast<int>(current), next + 2, ply, jobs);
+    else if (hold != static_cast<int>(current))
+        place(s, worker, matrix, static_cast<PieceType>(hold), static_cast<int>(current), next + 1, ply, jobs);
+}
+
+} // namespace
+
+PerftResult perft(const PerftOptions &options) {
+    const size_t depth = static_cast<size_t>(clamp(options.depth, 1, static_cast<int>(PieceQueue::kCapacity) - 2));
+
+    PerftResult result;
+    Rng rng(options.config.seed);
+    PieceQueue queue;
+    queue.reset(makeRandomizer(options.config.randomizer), rng);
+    for (size_t i = 0; i <= depth; i++) result.pieces.push_back(queue.peek(i));
+
+    const Search s{options, result.pieces, depth};
+    const auto begin = chrono::steady_clock::now();
+
+    // The first ply runs here and yields the jobs for the threads.
+    Worker root(depth);
+    vector<Job> jobs;
+    search(s, root, GameMatrix(), kNoHold, 0, 0, &jobs);
+
+    result.threads = options.threads > 0 ? options.threads : static_cast<int>(max(thread::hardware_concurrency(), 1u));
+    result.threads = static_cast<int>(min(static_cast<size_t>(result.threads), max(jobs.size(), size_t{1})));
+
+    vector<Worker> workers;
+    workers.reserve(static_cast<size_t>(result.threads));
+    for (int i = 0; i < result.threads; i++) workers.emplace_back(depth);
+
+    atomic<size_t> nextJob{0};
+    vector<thread> threads;
+    for (auto &worker : workers) {
+        threads.emplace_back([&s, &jobs, &nextJob, &worker] {
+            for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+                search(s, worker, jobs[i].state.matrix(), jobs[i].hold(), jobs[i].next, 1, nullptr);
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    result.nodes = root.nodes;
+    result.generateCalls = root.generateCalls;
+    vector<unordered_set<uint64_t>> seen = std::move(root.seen);
+    for (auto &worker : workers) {
+        for (size_t ply = 0; ply < depth; ply++) {
+            result.nodes[ply] += worker.nodes[ply];
+            if (options.distinct) seen[ply].insert(worker.seen[ply].begin(), worker.seen[ply].end());
+        }
+        result.generateCalls += worker.generateCalls;
+    }
+    if (options.distinct)
+        for (const auto &states : seen) result.distinct.push_back(states.size());
+
+    result.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    return result;
+}
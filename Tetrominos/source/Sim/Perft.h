@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GameState.h"
+#include "PieceData.h"
+
+struct PerftOptions {
+    GameConfig config; // seed, randomizer and holdEnabled select the piece sequence and moves
+    int depth = 3;
+    int threads = 0;     // 0 = one per hardware thread
+    bool distinct = true; // also count distinct (matrix, hold) states per depth
+};
+
+struct PerftResult {
+    std::vector<PieceType> pieces; // the queue the search drew from
+    std::vector<uint64_t> nodes;    // nodes[d]: placements made at ply d + 1, summed over all paths
+    std::vector<uint64_t> distinct; // distinct[d]: distinct states after d + 1 pieces (empty if not counted)
+    uint64_t generateCalls{};
+    double wallSeconds{};
+    int threads{};
+};
+
+// Like chess perft: walks every sequence of placements of the next `depth`
+// pieces from an empty matrix, using the move generator, and counts them per
+// ply. With hold enabled, each ply may also swap in the held piece (or the
+// next one when hold is empty). Work below the first ply is split across
+// threads; the counts do not depend on the thread count.
+[[nodiscard]] PerftResult perft(const PerftOptions &options);
@@ -0,0 +1,98 @@
+#include "SimRunner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Clock.h"
+#include "GameController.h"
+#include "GameState.h"
+#include "VariantRule.h"
+
+using namespace std;
+
+template <class Controller>
+static GameResult runGame(const GameVariant variant, const uint64_t seed, const SimOptions &options) {
+    ManualClock clock;
+    GameState state(clock);
+    Controller controller(clock);
+
+    state.config.variant = variant;
+    state.config.randomizer = options.randomizer;
+    state.config.seed = seed;
+    controller.configurePolicies(state.config.mode);
+    controller.configureVariant(variant, state);
+    controller.setTickRate(options.tickRate);
+    controller.start(state);
+
+    const unique_ptr<InputPolicy> policy = makeInputPolicy(options.policy, seed, options.script);
+
+    GameResult result;
+    result.variant = variant;
+    result.seed = seed;
+
+    const double tickSeconds = 1.0 / options.tickRate;
+    while (result.ticks < options.maxTicks) {
+        clock.advance(tickSeconds);
+        result.ticks++;
+        const StepResult step = controller.step(state, policy->next(state));
+        state.clearPendingSounds();
+        state.clearDirty();
+        if (step == StepResult::GameOver) {
+            result.finished = true;
+            break;
+        }
+    }
+
+    const int linesGoal = makeVariantRule(variant)->linesGoal();
+    result.score = state.stats.score;
+    result.lines = linesGoal > 0 ? linesGoal - state.stats.lines : static_cast<int>(state.stats.lines);
+    result.level = state.stats.level;
+    result.gameSeconds = state.gameElapsed();
+    return result;
+}
+
+// Games use the default Extended lock down, so each variant has a fixed rule
+// set whose policy calls are all direct.
+GameResult simulateGame(const GameVariant variant, const uint64_t seed, const SimOptions &options) {
+    if (options.runtimeRules) return runGame<GameController>(variant, seed, options);
+
+    switch (variant) {
+        case GameVariant::Marathon: return runGame<GuidelineController<MarathonVariant>>(variant, seed, options);
+        case GameVariant::Sprint: return runGame<GuidelineController<SprintVariant>>(variant, seed, options);
+        case GameVariant::Ultra: return runGame<GuidelineController<UltraVariant>>(variant, seed, options);
+        case GameVariant::Master: return runGame<GuidelineController<MasterVariant>>(variant, seed, options);
+    }
+    return runGame<GameController>(variant, seed, options);
+}
+
+SimReport runSimulation(const SimOptions &options) {
+    const size_t perVariant = static_cast<size_t>(max(options.games, 0));
+    const size_t total = perVariant * options.variants.size();
+
+    SimReport report;
+    report.games.resize(total);
+    report.threads = options.threads > 0 ? options.threads : static_cast<int>(max(thread::hardware_concurrency(), 1u));
+    report.threads = static_cast<int>(min(static_cast<size_t>(report.threads), max(total, size_t{1})));
+
+    // Workers pull job indices from a shared counter and write to their own
+    // slot, so no locking is needed and the output order is fixed.
+    atomic<size_t> nextJob{0};
+    const auto worker = [&] {
+        for (size_t job = nextJob++; job < total; job = nextJob++) {
+            const GameVariant variant = options.variants[job / perVariant];
+            const uint64_t seed = options.seed + job % perVariant;
+            report.games[job] = simulateGame(variant, seed, options);
+        }
+    };
+
+    const auto begin = chrono::steady_clock::now();
+    vector<thread> threads;
+    threads.reserve(static_cast<size_t>(report.threads));
+    for (int i = 0; i < report.threads; i++) threads.emplace_back(worker);
+    for (auto &t : threads) t.join();
+    report.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    return report;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+#include "InputPolicy.h"
+
+struct SimOptions {
+    int games = 100; // per variant
+    int threads = 0; // 0 = one per hardware thread
+    std::vector<GameVariant> variants{GameVariant::Marathon};
+    PolicyType policy = PolicyType::Bot;
+    std::string script; // ScriptedInputPolicy script, empty = default
+    RandomizerType randomizer = RandomizerType::SevenBag;
+    uint64_t seed = 1;            // game i of every variant uses seed + i
+    int64_t maxTicks = 108000;    // 30 minutes of game time at 60 Hz
+    int tickRate = 60;
+    bool runtimeRules = false; // step the runtime-configurable GameController instead of a GuidelineController
+};
+
+struct GameResult {
+    GameVariant variant{};
+    uint64_t seed{};
+    int64_t score{};
+    int lines{}; // lines cleared (Sprint counts down internally)
+    int level{};
+    int64_t ticks{};
+    double gameSeconds{};
+    bool finished{}; // false when stopped by maxTicks
+};
+
+struct SimReport {
+    std::vector<GameResult> games; // ordered by variant, then seed
+    double wallSeconds{};
+    int threads{};
+};
+
+// Plays one game to game over (or maxTicks) on its own ManualClock.
+[[nodiscard]] GameResult simulateGame(GameVariant variant, uint64_t seed, const SimOptions &options);
+
+// Plays options.games games of every variant across worker threads. Each game
+// owns its state, controller, clock and policy, so results do not depend on
+// the thread count or scheduling.
+[[nodiscard]] SimReport runSimulation(const SimOptions &options);
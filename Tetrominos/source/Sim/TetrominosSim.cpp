@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "DeadlineCheck.h"
+#include "Perft.h"
+#include "Rng.h"
+#include "SimRunner.h"
+
+using namespace std;
+
+// tetrominos-sim: plays many headless games in parallel and prints per-variant
+// score and line distributions as CSV on stdout, throughput on stderr.
+// With --perft it counts move-generator placements instead (see Perft.h), and
+// with --check-deadlines it checks that stepping games only at their deadlines
+// plays them as stepping every tick (see DeadlineCheck.h).
+
+static const char *variantName(const GameVariant variant) {
+    switch (variant) {
+        case GameVariant::Marathon: return "marathon";
+        case GameVariant::Sprint: return "sprint";
+        case GameVariant::Ultra: return "ultra";
+        case GameVariant::Master: return "master";
+    }
+    return "?";
+}
+
+static const char *policyName(const PolicyType policy) {
+    switch (policy) {
+        case PolicyType::Random: return "random";
+        case PolicyType::Scripted: return "scripted";
+        case PolicyType::Bot: return "bot";
+    }
+    return "?";
+}
+
+static bool parseVariants(const string &name, vector<GameVariant> &variants) {
+    if (name == "all") {
+        variants = {GameVariant::Marathon, GameVariant::Sprint, GameVariant::Ultra, GameVariant::Master};
+    } else if (name == "marathon") {
+        variants = {GameVariant::Marathon};
+    } else if (name == "sprint") {
+        variants = {GameVariant::Sprint};
+    } else if (name == "ultra") {
+        variants = {GameVariant::Ultra};
+    } else if (name == "master") {
+        variants = {GameVariant::Master};
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parsePolicy(const string &name, PolicyType &policy) {
+    for (const PolicyType p : {PolicyType::Random, PolicyType::Scripted, PolicyType::Bot}) {
+        if (name == policyName(p)) {
+            policy = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Nearest-rank percentile of an ascending vector.
+template <typename T>
+static T percentile(const vector<T> &sorted, const int p) {
+    if (sorted.empty()) return T{};
+    const size_t rank = (sorted.size() * static_cast<size_t>(p) + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+template <typename T>
+static double mean(const vector<T> &values) {
+    if (values.empty()) return 0;
+    double sum = 0;
+    for (const T v : values) sum += static_cast<double>(v);
+    return sum / static_cast<double>(values.size());
+}
+
+template <typename T>
+static void writeDistribution(ostream &out, vector<T> values) {
+    sort(values.begin(), values.end());
+    out << ',' << mean(values) << ',' << percentile(values, 10) << ',' << percentile(values, 50) << ','
+        << percentile(values, 90) << ',' << (values.empty() ? T{} : values.back());
+}
+
+static void writeSummary(ostream &out, const SimOptions &options, const SimReport &report) {
+    out << "variant,policy,games,finished,ticks_mean,"
+           "score_mean,score_p10,score_p50,score_p90,score_max,"
+           "lines_mean,lines_p10,lines_p50,lines_p90,lines_max\n";
+
+    for (const GameVariant variant : options.variants) {
+        vector<int64_t> scores;
+        vector<int> lines;
+        vector<int64_t> ticks;
+        int finished = 0;
+        for (const auto &game : report.games) {
+            if (game.variant != variant) continue;
+            scores.push_back(game.score);
+            lines.push_back(game.lines);
+            ticks.push_back(game.ticks);
+            if (game.finished) finished++;
+        }
+
+        out << variantName(variant) << ',' << policyName(options.policy) << ',' << scores.size() << ',' << finished
+            << ',' << mean(ticks);
+        writeDistribution(out, scores);
+        writeDistribution(out, lines);
+        out << '\n';
+    }
+}
+
+static void writeGames(ostream &out, const SimOptions &options, const SimReport &report) {
+    out << "variant,policy,seed,score,lines,level,ticks,game_seconds,finished\n";
+    for (const auto &game : report.games) {
+        out << variantName(game.variant) << ',' << policyName(options.policy) << ',' << game.seed << ',' << game.score
+            << ',' << game.lines << ',' << game.level << ',' << game.ticks << ',' << game.gameSeconds << ','
+            << (game.finished ? 1 : 0) << '\n';
+    }
+}
+
+static constexpr string_view kPieceNames = "IJLOSTZ";
+
+static int runPerft(PerftOptions options) {
+    if (options.config.seed == 0) options.config.seed = Rng::makeSeed();
+
+    const PerftResult result = perft(options);
+
+    string pieces;
+    for (const PieceType piece : result.pieces) pieces += kPieceNames[static_cast<size_t>(piece)];
+
+    uint64_t totalNodes = 0;
+    for (const uint64_t n : result.nodes) totalNodes += n;
+    const double seconds = max(result.wallSeconds, 1e-9);
+    cerr << "perft " << result.nodes.size() << " (seed " << options.config.seed << ", pieces " << pieces
+         << (options.config.holdEnabled ? ", hold" : "") << "): " << totalNodes << " nodes in " << result.wallSeconds
+         << " s on " << result.threads << " threads: " << static_cast<double>(totalNodes) / seconds << " nodes/s, "
+         << static_cast<double>(result.generateCalls) / seconds << " generate calls/s\n";
+
+    cout << "depth,nodes,distinct\n";
+    for (size_t ply = 0; ply < result.nodes.size(); ply++) {
+        cout << ply + 1 << ',' << result.nodes[ply] << ',';
+        if (ply < result.distinct.size()) cout << result.distinct[ply];
+        cout << '\n';
+    }
+    return 0;
+}
+
+static int runDeadlineCheck(const DeadlineCheckOptions &options) {
+    const DeadlineCheckResult result = checkDeadlines(options);
+
+    const double seconds = max(result.wallSeconds, 1e-9);
+    cerr << "deadlines (seed " << options.seed << ", " << options.tickRate << " Hz): " << result.denseTicks
+         << " ticks stepped every tick and " << result.sparseSteps << " at deadlines, " << result.games
+         << " games; timer wheel: " << result.wheelOperations << " operations; " << result.wallSeconds << " s on "
+         << result.threads << " threads, " << static_cast<double>(result.denseTicks) / seconds << " ticks/s\n";
+
+    for (const string &mismatch : result.mismatches) cout << "mismatch: " << mismatch << '\n';
+    for (const string &mismatch : result.wheelMismatches) cout << "timer wheel mismatch: " << mismatch << '\n';
+    const bool passed = result.mismatches.empty() && result.wheelMismatches.empty();
+    cout << (passed ? "ok" : "FAILED") << '\n';
+    return passed ? 0 : 1;
+}
+
+static void printUsage(const char *program) {
+    cerr << "Usage: " << program
+         << " [--games N] [--threads N] [--variant marathon|sprint|ultra|master|all]\n"
+            "       [--policy random|scripted|bot] [--script LRDHCWX.] [--seed N] [--max-ticks N]\n"
+            "       [--tick-rate HZ] [--runtime-rules] [--games-csv <file>]\n"
+            "   or: "
+         << program << " --perft DEPTH [--threads N] [--seed N] [--no-hold] [--no-distinct]\n"
+         << "   or: " << program << " --check-deadlines [--games N] [--threads N] [--seed N] [--max-ticks N]\n"
+         << "       [--tick-rate HZ]\n";
+}
+
+int main(int argc, char **argv) {
+    SimOptions options;
+    string gamesCsv;
+    PerftOptions perftOptions;
+    bool runsPerft = false;
+    bool checksDeadlines = false;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--games") == 0 && hasValue) {
+            options.games = stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            options.threads = stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--variant") == 0 && hasValue) {
+            if (!parseVariants(argv[++i], options.variants)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--policy") == 0 && hasValue) {
+            if (!parsePolicy(argv[++i], options.policy)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--script") == 0 && hasValue) {
+            options.script = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = stoull(argv[++i]);
+        } else if (strcmp(argv[i], "--max-ticks") == 0 && hasValue) {
+            options.maxTicks = stoll(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+            options.tickRate = clamp(stoi(argv[++i]), MIN_TICK_RATE, MAX_TICK_RATE);
+        } else if (strcmp(argv[i], "--games-csv") == 0 && hasValue) {
+            gamesCsv = argv[++i];
+        } else if (strcmp(argv[i], "--perft") == 0 && hasValue) {
+            runsPerft = true;
+            perftOptions.depth = stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--check-deadlines") == 0) {
+            checksDeadlines = true;
+        } else if (strcmp(argv[i], "--runtime-rules") == 0) {
+            options.runtimeRules = true;
+        } else if (strcmp(argv[i], "--no-hold") == 0) {
+            perftOptions.config.holdEnabled = false;
+        } else if (strcmp(argv[i], "--no-distinct") == 0) {
+            perftOptions.distinct = false;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (checksDeadlines) {
+        // Its own defaults, unless given: a few long games per rule set at the game's tick rate
+        DeadlineCheckOptions check;
+        check.threads = options.threads;
+        if (options.seed != SimOptions{}.seed) check.seed = options.seed;
+        if (options.games != SimOptions{}.games) check.games = options.games;
+        if (options.maxTicks != SimOptions{}.maxTicks) check.maxTicks = options.maxTicks;
+        if (options.tickRate != SimOptions{}.tickRate) check.tickRate = options.tickRate;
+        return runDeadlineCheck(check);
+    }
+
+    if (runsPerft) {
+        perftOptions.threads = options.threads;
+        perftOptions.config.seed = options.seed;
+        perftOptions.config.randomizer = options.randomizer;
+        return runPerft(perftOptions);
+    }
+
+    // Seed 0 would make every game draw a fresh seed; pick one base seed instead
+    // so the run is still reproducible from the printed value.
+    if (options.seed == 0) options.seed = Rng::makeSeed();
+
+    const SimReport report = runSimulation(options);
+
+    int64_t totalTicks = 0;
+    for (const auto &game : report.games) totalTicks += game.ticks;
+    const double seconds = max(report.wallSeconds, 1e-9);
+    cerr << report.games.size() << " games, " << totalTicks << " ticks in " << report.wallSeconds << " s on "
+         << report.threads << " threads (seed " << options.seed << "): "
+         << static_cast<double>(report.games.size()) / seconds << " games/s, "
+         << static_cast<double>(totalTicks) / seconds << " ticks/s\n";
+
+    writeSummary(cout, options, report);
+
+    if (!gamesCsv.empty()) {
+        ofstream file(gamesCsv);
+        if (!file) {
+            cerr << "Cannot write " << gamesCsv << "\n";
+            return 1;
+        }
+        writeGames(file, options, report);
+    }
+
+    return 0;
+}
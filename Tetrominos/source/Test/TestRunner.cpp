@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
@@ -12,49 +13,37 @@
 #include <thread>
 
 #include "Color.h"
+#include "HighScoreDisplay.h"
+#include "Menu.h"
 #include "Platform.h"
-#include "Timer.h"
+#include "Replay.h"
+#include "SimState.h"
+#include "Tetrominos.h"
 #include "rlutil.h"
 
 using namespace std;
 
-// Timer IDs used by the game engine
-static constexpr auto FALL = "fall";
-static constexpr auto LOCK_DOWN = "lockdown";
-static constexpr auto GENERATION = "generation";
-static constexpr auto ANIMATE = "animate";
+// The manual clock only moves when a scenario advances it, so gravity and
+// lock-down never fire between scripted inputs. Skipping this long is enough
+// to expire any phase delay (generation, line-clear animation, lock-down).
+static constexpr double kSkipDelay = 1.0;
 
-TestRunner::TestRunner() : _controller(Timer::instance()) {
+TestRunner::TestRunner() : _state(_clock), _controller(_clock) {
 }
 
 // ---------------------------------------------------------------------------
-// Ensure the piece at the current bag index is the desired type
+// Ensure the piece at the front of the queue is the desired type
 // ---------------------------------------------------------------------------
-void TestRunner::ensurePieceType(PieceType type) {
-    const int targetColor = getPieceData(type).color;
-    auto &bag = _state.pieces.bag;
-    const auto idx = _state.pieces.bagIndex;
-
-    if (bag[idx]->getColor() == targetColor) return;
-
-    const auto it = std::find_if(bag.begin() + static_cast<ptrdiff_t>(idx) + 1, bag.end(),
-                           [targetColor](const auto &p) { return p->getColor() == targetColor; });
-    if (it != bag.end()) {
-        bag[idx].swap(*it);
-        return;
-    }
+void TestRunner::ensurePieceType(const PieceType type) {
+    _state.pieces.queue.moveToFront(type);
 }
 
 // ---------------------------------------------------------------------------
 // Fast-forward through the Generation phase to spawn the current piece
 // ---------------------------------------------------------------------------
 void TestRunner::spawnPiece() {
-    Timer::instance().resetTimer(GENERATION, 999);
+    _clock.advance(kSkipDelay);
     _controller.step(_state, {});
-
-    // Reset rotation to NORTH — piece objects persist in the bag and may
-    // retain facing from a previous scenario.
-    if (_state.pieces.current) _state.pieces.current->resetRotation();
 }
 
 // ---------------------------------------------------------------------------
@@ -65,25 +54,23 @@ void TestRunner::applyPreRotations(int count) {
     rotateCW.rotateCW = true;
 
     for (int i = 0; i < count; i++) {
-        Timer::instance().resetTimer(FALL, 0);
         _controller.step(_state, rotateCW);
         _controller.step(_state, {}); // release to clear didRotate
     }
 }
 
 // ---------------------------------------------------------------------------
-// Force a hard drop: repeatedly step with fall timer set high until the
+// Force a hard drop: keep stepping with the clock skipped ahead until the
 // piece locks (phase leaves Falling)
 // ---------------------------------------------------------------------------
 void TestRunner::forceHardDrop() {
     InputSnapshot hardDrop{};
     hardDrop.hardDrop = true;
 
-    Timer::instance().resetTimer(FALL, 999);
     _controller.step(_state, hardDrop);
 
     for (int i = 0; i < 50 && _state.phase == GamePhase::Falling; i++) {
-        Timer::instance().resetTimer(FALL, 999);
+        _clock.advance(kSkipDelay);
         _controller.step(_state, {});
     }
 }
@@ -94,7 +81,7 @@ void TestRunner::forceHardDrop() {
 void TestRunner::fastForwardToCompletion() {
     for (int i = 0; i < 30; i++) {
         if (_state.phase == GamePhase::Completion || _state.phase == GamePhase::Generation) break;
-        if (_state.phase == GamePhase::Animate) Timer::instance().resetTimer(ANIMATE, 999);
+        if (_state.phase == GamePhase::Animate) _clock.advance(kSkipDelay);
         _controller.step(_state, {});
     }
     // Step through Completion to reach Generation
@@ -125,6 +112,7 @@ void TestRunner::runScenario(const TestScenario &scenario) {
     _controller.configurePolicies(LockDownMode::Extended);
     _controller.configureVariant(GameVariant::Marathon, _state);
     _renderer.configure(0, false, false);
+    _state.config.sonicDrop = scenario.sonicDrop;
     _controller.start(_state);
 
     // Set level and prevent level-ups during tests
@@ -133,7 +121,7 @@ void TestRunner::runScenario(const TestScenario &scenario) {
 
     // Fill matrix
     for (const auto &[row, col, color] : scenario.matrixCells)
-        _state.matrix[static_cast<size_t>(row)][static_cast<size_t>(col)] = color;
+        _state.matrix.set(row, col, color);
 
     // Ensure correct piece type in bag
     ensurePieceType(scenario.pieceType);
@@ -145,7 +133,7 @@ void TestRunner::runScenario(const TestScenario &scenario) {
     if (scenario.preRotations > 0) applyPreRotations(scenario.preRotations);
 
     // Teleport to prePosition
-    if (!_state.pieces.current->setPosition(scenario.prePosition)) {
+    if (!_state.pieces.current->setPosition(_state.matrix, scenario.prePosition)) {
         TestResult result;
         result.name = scenario.name;
         result.passed = false;
@@ -166,12 +154,20 @@ void TestRunner::runScenario(const TestScenario &scenario) {
     bool tSpinDetected = false;
     bool miniTSpinDetected = false;
 
+    if (scenario.fallSeconds > 0) {
+        _clock.advance(scenario.fallSeconds);
+        _controller.step(_state, {});
+    }
+
     for (const auto &action : scenario.actions) {
-        // Set fall timer: high for soft/hard drops (so they trigger), 0 otherwise
-        if (action.input.softDrop || action.input.hardDrop)
-            Timer::instance().resetTimer(FALL, 999);
-        else
-            Timer::instance().resetTimer(FALL, 0); // suppress gravity
+        // Drops need gravity to tick; other inputs run with the clock frozen. Gravity pays out every row owed
+        // since the last step, so advance by exactly one soft drop row.
+        if (action.input.softDrop || action.input.hardDrop) {
+            const TickTimings &timings = _controller.timings();
+            const int64_t gravity = timings.level(_state.stats.level).softGravity;
+            const int64_t rowTicks = (kGravityOne + gravity - 1) / gravity;
+            _clock.advance(static_cast<double>(rowTicks) / timings.tickRate);
+        }
 
         _controller.step(_state, action.input);
 
@@ -182,7 +178,6 @@ void TestRunner::runScenario(const TestScenario &scenario) {
         }
 
         // Release keys
-        Timer::instance().resetTimer(FALL, 0);
         _controller.step(_state, {});
 
         if (_state.phase == GamePhase::Falling) renderAndDelay(200);
@@ -201,17 +196,20 @@ void TestRunner::runScenario(const TestScenario &scenario) {
     // Render final state
     renderAndDelay(400);
 
+    GameSnapshot beforeExtraDrops;
+    if (scenario.undoExtraDrops) _controller.snapshot(_state, beforeExtraDrops);
+
     // Extra drops (for multi-piece scenarios like B2B and Combo)
     for (const auto &drop : scenario.extraDrops) {
         for (const auto &[row, col, color] : drop.matrixCells)
-            _state.matrix[static_cast<size_t>(row)][static_cast<size_t>(col)] = color;
+            _state.matrix.set(row, col, color);
 
         ensurePieceType(drop.pieceType);
         spawnPiece();
 
         if (drop.preRotations > 0) applyPreRotations(drop.preRotations);
 
-        if (!_state.pieces.current->setPosition(drop.prePosition)) {
+        if (!_state.pieces.current->setPosition(_state.matrix, drop.prePosition)) {
             TestResult result;
             result.name = scenario.name;
             result.passed = false;
@@ -230,6 +228,11 @@ void TestRunner::runScenario(const TestScenario &scenario) {
         renderAndDelay(200);
     }
 
+    if (scenario.undoExtraDrops) {
+        _controller.restore(_state, beforeExtraDrops);
+        renderAndDelay(400);
+    }
+
     // Record results
     int64_t scoreAfter = _state.stats.score;
     int linesAfter = _state.stats.lines;
@@ -337,6 +340,8 @@ void TestRunner::run() {
     const auto scenarios = buildScenarios();
     for (const auto &scenario : scenarios)
         runScenario(scenario);
+    runReplayScenarios();
+    checkSimStateRestore();
 
     writeReport();
 
@@ -392,6 +397,364 @@ void TestRunner::writeReport() const {
     out.close();
 }
 
+// ===========================================================================
+// REPLAY SCENARIOS
+// ===========================================================================
+
+namespace {
+
+constexpr uint64_t kReplaySeed = 20240611;
+constexpr int kReplayTickRate = 1000;
+constexpr int64_t kReplayMaxTicks = 120 * kReplayTickRate; // two minutes of game time
+constexpr int64_t kScriptStepTicks = 40; // each script character is held this long
+// Taps to spread the pieces over the columns, with rotations, a hold, a soft drop and gaps of no keys
+constexpr string_view kReplayScript = "L.L.L.L.L.H..L.L.L.H..L.H..R.H..R.R.R.H..R.R.R.R.R.H.."
+                                      "C.L.L.L.L.H..C.R.R.R.R.H..X.H..W.DDD.H..";
+
+// Plays back without a terminal: no keys, no sound
+class SilentInput final : public InputSource {
+public:
+    InputSnapshot poll() override { return {}; }
+};
+
+class SilentAudio final : public AudioSink {
+public:
+    void playSound(GameSound) override {}
+    void playMusic(const string &) override {}
+    void pauseMusic() override {}
+    void unpauseMusic() override {}
+    void stopMusic() override {}
+    [[nodiscard]] bool musicEnded() const override { return false; }
+    [[nodiscard]] string currentMusic() const override { return {}; }
+    void setMusicVolume(float) override {}
+    void setEffectVolume(float) override {}
+    void setSoundtrackMode(SoundtrackMode) override {}
+    [[nodiscard]] float musicVolume() const override { return 0; }
+    [[nodiscard]] float effectVolume() const override { return 0; }
+    [[nodiscard]] SoundtrackMode soundtrackMode() const override { return {}; }
+};
+
+InputSnapshot scriptedInput(const int64_t tick) {
+    InputSnapshot input;
+    switch (kReplayScript[static_cast<size_t>(tick / kScriptStepTicks) % kReplayScript.size()]) {
+        case 'L': input.left = true; break;
+        case 'R': input.right = true; break;
+        case 'D': input.softDrop = true; break;
+        case 'H': input.hardDrop = true; break;
+        case 'C': input.rotateCW = true; break;
+        case 'W': input.rotateCCW = true; break;
+        case 'X': input.hold = true; break;
+        default: break;
+    }
+    return input;
+}
+
+struct RecordedGame {
+    Replay replay;
+    uint64_t hash{};
+    int64_t score{};
+    int lines{};
+};
+
+// A live game as the facade records it: every stepped tick is recorded before
+// the controller runs. `frameTicks` > 1 steps once per frame, as the version
+// 1-2 builds did, leaving gaps between the recorded ticks.
+RecordedGame recordGame(const int64_t frameTicks) {
+    ManualClock clock;
+    GameState state(clock);
+    GameController controller(clock);
+    state.config.seed = kReplaySeed;
+    state.config.startingLevel = 5;
+    controller.configurePolicies(state.config.mode);
+    controller.configureVariant(state.config.variant, state);
+    controller.setTickRate(kReplayTickRate);
+    controller.start(state);
+
+    ReplayRecorder recorder;
+    recorder.begin(state.seed, state.config, kReplayTickRate, 0);
+    for (int64_t frame = 1;; frame++) {
+        // Frames of 1/60 s fall on 16 or 17 whole milliseconds
+        const int64_t tick = frameTicks > 1 ? frame * kReplayTickRate / 60 : frame;
+        if (tick > kReplayMaxTicks) break;
+        const InputSnapshot input = scriptedInput(tick);
+        recorder.record(input, tick);
+        clock.set(static_cast<double>(tick) / kReplayTickRate);
+        if (controller.step(state, input) == StepResult::GameOver) break;
+    }
+
+    RecordedGame game;
+    const string path = Platform::getDataDir() + "/test_replay.tcr";
+    if (recorder.finish(path) && loadReplay(game.replay, path)) {
+        game.hash = state.hash();
+        game.score = state.stats.score;
+        game.lines = state.stats.lines;
+    }
+    remove(path.c_str());
+    return game;
+}
+
+template <typename T>
+void writeField(ostream &out, const T value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void writeVarint(ostream &out, uint64_t value) {
+    for (; value >= 0x80; value >>= 7) out.put(static_cast<char>((value & 0x7F) | 0x80));
+    out.put(static_cast<char>(value));
+}
+
+// The version 1 and 2 layout: no tick rate (whole milliseconds), and version 1
+// has no sonic drop byte.
+bool writeLegacyReplay(const Replay &replay, const string &path, const uint32_t version) {
+    ofstream out(path, ios::binary);
+    writeField(out, uint32_t{0x50524354});
+    writeField(out, version);
+    writeField(out, replay.seed);
+    writeField(out, replay.startTick);
+    const GameConfig &c = replay.config;
+    for (const int value : {static_cast<int>(c.variant), static_cast<int>(c.mode), static_cast<int>(c.randomizer),
+                            c.startingLevel, c.previewCount})
+        writeField(out, static_cast<int32_t>(value));
+    writeField(out, static_cast<uint8_t>(c.ghostEnabled));
+    writeField(out, static_cast<uint8_t>(c.holdEnabled));
+    if (version >= 2) writeField(out, static_cast<uint8_t>(c.sonicDrop));
+    writeVarint(out, replay.runs.size());
+    for (const ReplayRun &run : replay.runs) {
+        out.put(static_cast<char>(run.input));
+        writeVarint(out, run.deltaTicks);
+        writeVarint(out, run.count);
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+void TestRunner::runReplayScenarios() {
+    checkReplayPlayback("Replay Round Trip", 3, 1);
+    checkReplayPlayback("Replay Version 2 Gaps", 2, kReplayTickRate / 60);
+    checkReplayPlayback("Replay Version 1 Gaps", 1, kReplayTickRate / 60);
+    checkReplayRejection();
+}
+
+// Records a scripted game, saves it in the given format version, loads it and
+// plays it back through the facade at 60 frames per second. The playback must
+// end on the recorded board, queue and hold, score and lines.
+void TestRunner::checkReplayPlayback(const string &name, const uint32_t version, const int64_t frameTicks) {
+    TestResult result;
+    result.name = name;
+    result.expected = "Playback ends on the recorded game";
+
+    const RecordedGame recorded = recordGame(frameTicks);
+    Replay replay = recorded.replay;
+    const string path = Platform::getDataDir() + "/test_replay.tcr";
+    const bool saved = version == 3 ? saveReplay(replay, path) : writeLegacyReplay(replay, path, version);
+    const bool loaded = saved && loadReplay(replay, path);
+    remove(path.c_str());
+    if (recorded.replay.runs.empty() || !loaded || replay.tickRate != kReplayTickRate ||
+        replay.runs.size() != recorded.replay.runs.size()) {
+        result.detail = "Replay did not save and load";
+        _results.push_back(result);
+        printProgress();
+        return;
+    }
+
+    ManualClock wall;
+    SilentInput input;
+    SilentAudio audio;
+    const Session session{wall, input, audio, _output};
+    Menu pauseMenu("PAUSE");
+    Menu gameOverMenu("GAME OVER", "New High Score!");
+    HighScoreDisplay highScoreDisplay;
+    Tetrominos game(session, pauseMenu, gameOverMenu, highScoreDisplay);
+    game.startPlayback(std::move(replay));
+    game.start();
+    const int64_t maxFrames = (kReplayMaxTicks / kReplayTickRate + 1) * 60;
+    for (int64_t frame = 0; frame < maxFrames && !game.backToMenu(); frame++) {
+        wall.advance(1.0 / 60);
+        game.step();
+    }
+
+    const GameState &state = game.state();
+    result.scoreBefore = recorded.score;
+    result.scoreAfter = state.stats.score;
+    result.linesBefore = recorded.lines;
+    result.linesAfter = state.stats.lines;
+    ostringstream detail;
+    detail << "Score: " << recorded.score << " -> " << state.stats.score << ", Lines: " << recorded.lines << " -> "
+           << state.stats.lines << ", Hash " << (state.hash() == recorded.hash ? "matches" : "differs");
+    result.detail = detail.str();
+    result.passed = game.backToMenu() && recorded.score > 0 && state.hash() == recorded.hash &&
+                    state.stats.score == recorded.score && state.stats.lines == recorded.lines;
+    _results.push_back(result);
+    printProgress();
+}
+
+// loadReplay() must refuse a config the game would index out of range with,
+// and still accept the limits of each range.
+void TestRunner::checkReplayRejection() {
+    TestResult result;
+    result.name = "Replay Rejects Bad Config";
+    result.expected = "Out-of-range fields rejected, limits accepted";
+    result.passed = true;
+
+    Replay replay;
+    replay.seed = kReplaySeed;
+    replay.config.seed = kReplaySeed;
+    replay.runs.push_back({0, 1, 10});
+    const string path = Platform::getDataDir() + "/test_replay.tcr";
+    string bytes;
+    if (saveReplay(replay, path)) {
+        ifstream in(path, ios::binary);
+        bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+
+    // Offsets of the int32 fields in a version 3 file
+    struct Patch {
+        const char *field;
+        size_t offset;
+        int32_t value;
+        bool loads;
+    };
+    static constexpr Patch kPatches[] = {
+        {"tick rate", 16, MIN_TICK_RATE - 1, false}, {"tick rate", 16, MAX_TICK_RATE, true},
+        {"variant", 28, -1, false},                  {"variant", 28, static_cast<int32_t>(VARIANT_COUNT), false},
+        {"mode", 32, 3, false},                      {"randomizer", 36, 4, false},
+        {"level", 40, MIN_LEVEL - 1, false},         {"level", 40, MAX_MASTER_LEVEL + 1, false},
+        {"level", 40, MAX_MASTER_LEVEL, true},       {"preview", 44, -1, false},
+        {"preview", 44, 7, false},                   {"preview", 44, 64, false},
+        {"preview", 44, 0, true},
+    };
+
+    ostringstream detail;
+    detail << (bytes.empty() ? "Replay did not save" : "All cases as expected");
+    for (const Patch &patch : kPatches) {
+        if (bytes.size() < patch.offset + sizeof(int32_t)) break;
+        string patched = bytes;
+        memcpy(&patched[patch.offset], &patch.value, sizeof(int32_t));
+        {
+            ofstream out(path, ios::binary);
+            out.write(patched.data(), static_cast<streamsize>(patched.size()));
+        }
+        Replay loaded;
+        if (loadReplay(loaded, path) == patch.loads) continue;
+        if (result.passed) detail.str("");
+        detail << patch.field << " " << patch.value << (patch.loads ? " rejected; " : " loaded; ");
+        result.passed = false;
+    }
+    remove(path.c_str());
+    if (bytes.empty()) result.passed = false;
+
+    result.detail = detail.str();
+    _results.push_back(result);
+    printProgress();
+}
+
+namespace {
+
+constexpr int64_t kRestoreInterval = 97; // ticks; each restored game is checked until the next restore
+constexpr int kPrefilledRows = 2; // full but for columns 0-1, so the script clears lines
+
+// The snapshot with every field a SimState holds moved off its value: the
+// matrix emptied, the counters and flags changed, the pieces swapped for none
+// or an O, and the SimState's part of the queue shifted to other pieces. Only
+// GameState::restore(const SimState &) can put them back.
+GameSnapshot scrambled(GameSnapshot snapshot) {
+    snapshot.matrix = {};
+    Stats &stats = snapshot.stats;
+    stats.score += 1;
+    for (SecureValue<int> *value : {&stats.level, &stats.lines, &stats.goal, &stats.quad, &stats.combos,
+                                    &stats.currentCombo, &stats.tSpins, &stats.nbMinos})
+        ++*value;
+    stats.backToBackBonus = !stats.backToBackBonus;
+    snapshot.lockDown.active = !snapshot.lockDown.active;
+    snapshot.lockDown.moveCount++;
+    snapshot.lockDown.lowestLine++;
+    for (size_t i = 0; i < SimState::kQueueLength; i++) {
+        PieceType &piece = snapshot.queue.ring[(snapshot.queue.head + i) % PieceQueue::kCapacity];
+        piece = static_cast<PieceType>((static_cast<int>(piece) + 1) % PIECE_TYPE_COUNT);
+    }
+    for (optional<Tetrimino> *piece : {&snapshot.current, &snapshot.hold})
+        *piece = *piece ? nullopt : optional(Tetrimino(PieceType::O));
+    snapshot.isNewHold = !snapshot.isNewHold;
+    snapshot.fallProgress++;
+    FrameFlags &flags = snapshot.flags;
+    flags.stepState = flags.stepState == GameStep::Idle ? GameStep::HardDrop : GameStep::Idle;
+    flags.didRotate = !flags.didRotate;
+    flags.lastMoveIsTSpin = !flags.lastMoveIsTSpin;
+    flags.lastMoveIsMiniTSpin = !flags.lastMoveIsMiniTSpin;
+    flags.isGameOver = !flags.isGameOver;
+    snapshot.phase = snapshot.phase == GamePhase::Falling ? GamePhase::Generation : GamePhase::Falling;
+    snapshot.clearingRows = 0;
+    return snapshot;
+}
+
+} // namespace
+
+// Plays the scripted replay game over a prefilled stack. At every phase
+// change and every kRestoreInterval ticks, a second game is restored to the
+// first one's GameSnapshot with its SimState part scrambled, and then to the
+// SimState. Until the next restore both step the same input, and after every
+// tick they must capture the same SimState and hash.
+void TestRunner::checkSimStateRestore() {
+    TestResult result;
+    result.name = "SimState Restore";
+    result.expected = "A restored SimState steps as the original";
+
+    ManualClock clock;
+    GameState original(clock);
+    GameState restored(clock);
+    GameController originalController(clock);
+    GameController restoredController(clock);
+    for (auto [state, controller] : {pair{&original, &originalController}, pair{&restored, &restoredController}}) {
+        state->config.seed = kReplaySeed;
+        state->config.startingLevel = 5;
+        controller->configurePolicies(state->config.mode);
+        controller->configureVariant(state->config.variant, *state);
+        controller->setTickRate(kReplayTickRate);
+        controller->start(*state);
+    }
+    for (int row = MATRIX_END; row > MATRIX_END - kPrefilledRows; row--)
+        for (int column = 2; column < BOARD_WIDTH; column++) original.matrix.set(row, column, Color::GREY);
+
+    int restores = 0;
+    int64_t mismatch = -1;
+    int64_t tick = 1;
+    for (GamePhase phase = original.phase; tick <= kReplayMaxTicks; tick++) {
+        if ((tick - 1) % kRestoreInterval == 0 || original.phase != phase) {
+            phase = original.phase;
+            GameSnapshot snapshot;
+            originalController.snapshot(original, snapshot);
+            restoredController.restore(restored, scrambled(snapshot));
+            restored.restore(SimState::capture(original));
+            restores++;
+        }
+        clock.set(static_cast<double>(tick) / kReplayTickRate);
+        const InputSnapshot input = scriptedInput(tick);
+        const StepResult step = originalController.step(original, input);
+        const bool sameStep = restoredController.step(restored, input) == step;
+        const SimState expected = SimState::capture(original);
+        const SimState actual = SimState::capture(restored);
+        if (!sameStep || memcmp(&expected, &actual, sizeof(SimState)) != 0 || original.hash() != restored.hash()) {
+            mismatch = tick;
+            break;
+        }
+        if (step == StepResult::GameOver) break;
+    }
+
+    result.scoreBefore = result.scoreAfter = original.stats.score;
+    result.linesBefore = result.linesAfter = original.stats.lines;
+    ostringstream detail;
+    detail << restores << " restores, ";
+    if (mismatch >= 0)
+        detail << "first mismatch at tick " << mismatch;
+    else
+        detail << min(tick, kReplayMaxTicks) << " ticks matched";
+    result.detail = detail.str();
+    result.passed = mismatch < 0 && restores > 1 && original.stats.lines > 0;
+    _results.push_back(result);
+    printProgress();
+}
+
 // ===========================================================================
 // SCENARIO DEFINITIONS
 // ===========================================================================
@@ -600,6 +963,51 @@ vector<TestScenario> TestRunner::buildScenarios() {
         scenarios.push_back(s);
     }
 
+    // Multi-Row Gravity: level 15 falls a row every 7 ticks; 70 ticks in one step fall 10 rows, not 1
+    {
+        TestScenario s;
+        s.name = "Multi-Row Gravity";
+        s.description = "One step pays out every row of gravity owed";
+        s.pieceType = PieceType::T;
+        s.startingLevel = 15;
+        s.prePosition = {21, 5};
+        s.fallSeconds = 0.07;
+        s.hardDropAfterActions = false;
+        s.expected.scoreChange = 0;
+        s.expected.piecePosition = Vector2i{31, 5};
+        scenarios.push_back(s);
+    }
+
+    // 20G: level 20 gravity is capped at 20 rows per 1/60 s, enough to land from the top of the matrix
+    {
+        TestScenario s;
+        s.name = "20G Gravity";
+        s.description = "Level 20 drops the piece onto the stack within a frame";
+        s.pieceType = PieceType::T;
+        s.startingLevel = 20;
+        s.prePosition = {21, 5};
+        s.fallSeconds = 1.0 / 60;
+        s.hardDropAfterActions = false;
+        s.expected.scoreChange = 0;
+        s.expected.piecePosition = Vector2i{39, 5};
+        scenarios.push_back(s);
+    }
+
+    // Sonic Drop: T at (30,5) NORTH, one soft drop falls all 9 rows without locking → score = 9
+    {
+        TestScenario s;
+        s.name = "Sonic Drop";
+        s.description = "Sonic drop moves to the bottom, 1 point per row";
+        s.pieceType = PieceType::T;
+        s.prePosition = {30, 5};
+        s.sonicDrop = true;
+        s.actions = {{makeSoftDrop()}};
+        s.hardDropAfterActions = false;
+        s.expected.scoreChange = 9;
+        s.expected.piecePosition = Vector2i{39, 5};
+        scenarios.push_back(s);
+    }
+
     // Hard Drop + Lock: I at (30,4) NORTH, drops 9 rows → score = 2 * 9 = 18
     {
         TestScenario s;
@@ -773,6 +1181,31 @@ vector<TestScenario> TestRunner::buildScenarios() {
         scenarios.push_back(s);
     }
 
+    // Undo: the Back-to-Back Quad setup, but the second Quad is rolled back to
+    // the snapshot taken after the first → only the first 800 and 4 lines count.
+    {
+        TestScenario s;
+        s.name = "Snapshot Restore";
+        s.description = "Restoring a snapshot undoes a whole piece, score and lines included";
+        s.pieceType = PieceType::I;
+        s.preRotations = 1; // EAST (vertical)
+        for (int row = 32; row <= 39; row++)
+            addRow(s.matrixCells, row, "XXXXXXXXX.");
+        s.prePosition = {37, 8};
+
+        DropSpec drop2;
+        drop2.pieceType = PieceType::I;
+        drop2.preRotations = 1;
+        drop2.prePosition = {37, 8};
+        s.extraDrops.push_back(drop2);
+        s.undoExtraDrops = true;
+
+        s.expected.scoreChange = 800;
+        s.expected.linesCleared = 4;
+        s.expected.backToBackActive = true;
+        scenarios.push_back(s);
+    }
+
     // Combo: 3 consecutive clears. Combo counter reaches 2.
     // 4 rows with 4-col gap (cols 6-9). Drops 1,2: I NORTH fills cols 6-9.
     // Drop 3: Add cols 6,7 to row 39 → 2-col gap. J WEST fills cols 8,9.
@@ -7,6 +7,8 @@
 #include <tuple>
 #include <vector>
 
+#include "Clock.h"
+#include "ConsoleSession.h"
 #include "Constants.h"
 #include "GameController.h"
 #include "GameRenderer.h"
@@ -53,9 +55,14 @@ struct TestScenario {
     std::vector<TestAction> actions;
     // Whether to hard drop after the action sequence (locks piece)
     bool hardDropAfterActions = true;
+    bool sonicDrop = false;
+    // Seconds of plain gravity to run in a single step before the actions
+    double fallSeconds = 0;
     TestExpectation expected;
     // Additional drops after the main piece (for multi-piece scenarios)
     std::vector<DropSpec> extraDrops;
+    // Snapshot the game before the extra drops and restore it after them
+    bool undoExtraDrops = false;
 };
 
 struct TestResult {
@@ -80,6 +87,12 @@ public:
 
 private:
     void runScenario(const TestScenario &scenario);
+    // Replays: record, save, load and play back through the Tetrominos facade
+    void runReplayScenarios();
+    void checkReplayPlayback(const std::string &name, uint32_t version, int64_t frameTicks);
+    void checkReplayRejection();
+    // A SimState restored into a game steps as the game it was captured from
+    void checkSimStateRestore();
     void ensurePieceType(PieceType type);
     void spawnPiece();
     void applyPreRotations(int count);
@@ -91,9 +104,11 @@ private:
 
     static std::vector<TestScenario> buildScenarios();
 
+    ManualClock _clock;
     GameState _state;
     GameController _controller;
-    GameRenderer _renderer;
+    ConsoleOutput _output;
+    GameRenderer _renderer{_output};
     std::vector<TestResult> _results;
 };
 